@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "ByteRing.h"
+
+
+/***** Function definitions *****/
+void ByteRing_init(struct ByteRing* ring, uint8_t* buffer, uint16_t size)
+{
+    ring->buffer = buffer;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overruns = 0;
+    ring->highWater = 0;
+}
+
+uint16_t ByteRing_write(struct ByteRing* ring, const uint8_t* data, uint16_t length)
+{
+    uint16_t head = ring->head;
+    uint16_t used = head - ring->tail;
+    uint16_t space = (ring->mask + 1) - used;
+    uint16_t i;
+
+    if (length > space)
+    {
+        ring->overruns += length - space;
+        length = space;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        ring->buffer[(uint16_t)(head + i) & ring->mask] = data[i];
+    }
+
+    /* Publish the bytes only after they are stored */
+    ring->head = head + length;
+
+    if ((uint16_t)(used + length) > ring->highWater)
+    {
+        ring->highWater = used + length;
+    }
+
+    return length;
+}
+
+uint16_t ByteRing_read(struct ByteRing* ring, uint8_t* data, uint16_t maxLength)
+{
+    uint16_t tail = ring->tail;
+    uint16_t length = ring->head - tail;
+    uint16_t i;
+
+    if (length > maxLength)
+    {
+        length = maxLength;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        data[i] = ring->buffer[(uint16_t)(tail + i) & ring->mask];
+    }
+
+    /* Release the space only after the bytes are copied out */
+    ring->tail = tail + length;
+
+    return length;
+}
+
+uint16_t ByteRing_count(const struct ByteRing* ring)
+{
+    return ring->head - ring->tail;
+}
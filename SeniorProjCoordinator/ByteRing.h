@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BYTERING_H_
+#define BYTERING_H_
+
+#include "stdint.h"
+
+/* Single producer, single consumer byte ring.
+ *
+ * The producer only writes head and the consumer only writes tail, so one side may run in an
+ * interrupt or callback while the other runs in a task without any locking. Both indexes run
+ * freely and are masked on access, so the size must be a power of two and at most 32768. */
+struct ByteRing {
+    volatile uint8_t* buffer;   /* Volatile like the indexes, so the copies stay on their side of the index updates */
+    uint16_t mask;
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    /* Statistics, written by the producer */
+    uint32_t overruns;          /* Bytes dropped because the ring was full */
+    uint16_t highWater;         /* Largest fill level seen */
+};
+
+/* Initializes a ring on top of buffer, size must be a power of two */
+void ByteRing_init(struct ByteRing* ring, uint8_t* buffer, uint16_t size);
+
+/* Producer side, copies as many bytes as fit and counts the rest as overruns.
+ * Returns the number of bytes written. */
+uint16_t ByteRing_write(struct ByteRing* ring, const uint8_t* data, uint16_t length);
+
+/* Consumer side, copies up to maxLength bytes out of the ring.
+ * Returns the number of bytes read. */
+uint16_t ByteRing_read(struct ByteRing* ring, uint8_t* data, uint16_t maxLength);
+
+/* Returns the number of bytes waiting in the ring */
+uint16_t ByteRing_count(const struct ByteRing* ring);
+
+#endif /* BYTERING_H_ */
@@ -40,6 +40,7 @@ and humidity.
 #include <xdc/std.h>
 #include <xdc/runtime/System.h>
 #include <stdlib.h>
+#include <stddef.h>
 
 #include "CoordinatorRFTask.h"
 
@@ -62,6 +63,7 @@ and humidity.
 #include "CoordinatorRFTask.h"
 #include "CoordinatorTask.h"
 #include "GPS.h"
+#include "NetworkTime.h"
 
 
 
@@ -84,8 +86,8 @@ Event_Struct coordinatorOperationEvent;  /* not static so you can see in ROV */
 
 static CoordinatorRadio_PacketReceivedCallback packetReceivedCallback;
 static union CoordinatorPacket latestRxPacket;
-static EasyLink_TxPacket txPacket;
-static struct AckPacket ackPacket;  //Found in RadioProtocol.h
+static EasyLink_TxBuffer txBuffer;
+static struct AckPacket* const ackPacket = (struct AckPacket*)txBuffer.payload;  //Found in RadioProtocol.h, built in place in the TX buffer
 static uint8_t coordinatorAddress; // 0x00
 static int8_t latestRssi;
 
@@ -168,13 +170,15 @@ void coordinatorRFTaskFunction(UArg arg0, UArg arg1)
 
     /* Set up Ack packet */
     /*
-    AckPacket is in RadioProtocol.h and contains only a header
-    (which contains a source address and packet type). We now
+    AckPacket is in RadioProtocol.h and contains a header
+    (which contains a source address and packet type) and the
+    network time, which is filled in by sendAck. We now
     proceed creating the Ack packet below
     */
 
-    ackPacket.header.sourceAddress = coordinatorAddress;            //First byte is the address 0x00
-    ackPacket.header.packetType = RADIO_PACKET_TYPE_ACK_PACKET;     //Second byte of the header is the packet type
+    ackPacket->header.sourceAddress = coordinatorAddress;           //First byte is the address 0x00
+    ackPacket->header.packetType = RADIO_PACKET_TYPE_ACK_PACKET;    //Second byte of the header is the packet type
+    txBuffer.len = sizeof(struct AckPacket);
 
     if(EasyLink_receiveAsync(rxDoneCallback, 0) != EasyLink_Status_Success)
     {
@@ -226,17 +230,16 @@ void coordinatorRFTaskFunction(UArg arg0, UArg arg1)
 static void sendAck(uint8_t latestSourceAddress) {
 
     /* Set destinationAdress, but use EasyLink layers destination adress capability */
-    txPacket.dstAddr[0] = latestSourceAddress;
+    txBuffer.dstAddr[0] = latestSourceAddress;
 
-    /* Copy ACK packet to payload, skipping the destination adress byte.
-     * Note that the EasyLink API will implcitily both add the length byte and the destination address byte. */
-    memcpy(txPacket.payload, &ackPacket.header, sizeof(ackPacket));
-    txPacket.len = sizeof(ackPacket);
+    /* Stamp the network time as close to the transmission as possible */
+    ackPacket->networkTimeMs = NetworkTime_now();
 
-    /* Send packet  */
-    if (EasyLink_transmit(&txPacket) != EasyLink_Status_Success)
+    /* Send packet straight from the TX buffer, the ACK packet was built in its payload.
+     * Note that the EasyLink API will implcitily both add the length byte and the destination address byte. */
+    if (EasyLink_transmitBuffer(&txBuffer) != EasyLink_Status_Success)
     {
-        System_abort("EasyLink_transmit failed");
+        System_abort("EasyLink_transmitBuffer failed");
     }
 }
 
@@ -263,7 +266,8 @@ static void rxDoneCallback(EasyLink_RxPacket * rxPacket, EasyLink_Status status)
         tmpRxPacket = (union ConcentratorPacket*)(rxPacket->payload);
 
         /* If this is a known packet */
-        if (tmpRxPacket->header.packetType == RADIO_PACKET_TYPE_ADC_SENSOR_PACKET)
+        if ((tmpRxPacket->header.packetType == RADIO_PACKET_TYPE_ADC_SENSOR_PACKET) &&
+            (rxPacket->len >= sizeof(struct AdcSensorPacket)))
         {
             /* Save packet */
             memcpy((void*)&latestRxPacket, &rxPacket->payload, sizeof(struct AdcSensorPacket));
@@ -271,10 +275,16 @@ static void rxDoneCallback(EasyLink_RxPacket * rxPacket, EasyLink_Status status)
             /* Signal packet received */
             Event_post(radioOperationEventHandle, RADIO_EVENT_VALID_PACKET_RECEIVED);
         }
-        else if (tmpRxPacket->header.packetType == RADIO_PACKET_TYPE_DM_SENSOR_PACKET)
+        /* Routers without network time send the packet up to, but without, the timestamp */
+        else if ((tmpRxPacket->header.packetType == RADIO_PACKET_TYPE_DM_SENSOR_PACKET) &&
+                 (rxPacket->len >= offsetof(struct DualModeSensorPacket, networkTimeMs)))
         {
             /* Save packet */
             memcpy((void*)&latestRxPacket, &rxPacket->payload, sizeof(struct DualModeSensorPacket));
+            if (rxPacket->len < sizeof(struct DualModeSensorPacket))
+            {
+                latestRxPacket.dmSensorPacket.networkTimeMs = RADIO_NETWORK_TIME_UNKNOWN;
+            }
 
             /* Signal packet received */
             Event_post(radioOperationEventHandle, RADIO_EVENT_VALID_PACKET_RECEIVED);
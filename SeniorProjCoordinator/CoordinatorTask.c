@@ -82,6 +82,8 @@ struct AdcSensorNode {
     uint16_t latestAdcValue;
     uint8_t button;
     int8_t latestRssi;
+    uint8_t powerPolicy;    /* Non zero when the router is in a battery conservation mode */
+    uint32_t networkTimeMs; /* When the router took the latest sample, RADIO_NETWORK_TIME_UNKNOWN if not synchronized */
 };
 
 
@@ -133,6 +135,23 @@ void CoordinatorTask_init(void) {
 }
 
 
+uint8_t CoordinatorTask_getPowerPolicy(uint8_t* address)
+{
+    uint8_t powerPolicy = 0;
+    uint8_t i;
+
+    *address = 0;
+    for (i = 0; i < COORDINATOR_MAX_NODES; i++)
+    {
+        if (knownSensorNodes[i].powerPolicy > powerPolicy)
+        {
+            powerPolicy = knownSensorNodes[i].powerPolicy;
+            *address = knownSensorNodes[i].address;
+        }
+    }
+    return powerPolicy;
+}
+
 static void coordinatorTaskFunction(UArg arg0, UArg arg1)
 {
 
@@ -172,6 +191,8 @@ static void packetReceivedCallback(union CoordinatorPacket* packet, int8_t rssi)
         latestActiveAdcSensorNode.latestAdcValue = packet->adcSensorPacket.adcValue;
         latestActiveAdcSensorNode.button = 0; //no button value in ADC packet
         latestActiveAdcSensorNode.latestRssi = rssi;
+        latestActiveAdcSensorNode.powerPolicy = 0; //no power policy in ADC packet
+        latestActiveAdcSensorNode.networkTimeMs = RADIO_NETWORK_TIME_UNKNOWN; //no timestamp in ADC packet
 
         Event_post(coordinatorEventHandle, COORDINATOR_EVENT_NEW_ADC_SENSOR_VALUE);
     }
@@ -184,6 +205,8 @@ static void packetReceivedCallback(union CoordinatorPacket* packet, int8_t rssi)
         latestActiveAdcSensorNode.latestAdcValue = packet->dmSensorPacket.adcValue;
         latestActiveAdcSensorNode.button = packet->dmSensorPacket.button;
         latestActiveAdcSensorNode.latestRssi = rssi;
+        latestActiveAdcSensorNode.powerPolicy = packet->dmSensorPacket.powerPolicy;
+        latestActiveAdcSensorNode.networkTimeMs = packet->dmSensorPacket.networkTimeMs;
 
         Event_post(coordinatorEventHandle, COORDINATOR_EVENT_NEW_ADC_SENSOR_VALUE);
     }
@@ -211,6 +234,8 @@ static void updateNode(struct AdcSensorNode* node) {
             knownSensorNodes[i].latestAdcValue = node->latestAdcValue;
             knownSensorNodes[i].latestRssi = node->latestRssi;
             knownSensorNodes[i].button = node->button;
+            knownSensorNodes[i].powerPolicy = node->powerPolicy;
+            knownSensorNodes[i].networkTimeMs = node->networkTimeMs;
             break;
         }
     }
@@ -33,7 +33,14 @@
 #ifndef TASKS_COORDINATORTASK_H_
 #define TASKS_COORDINATORTASK_H_
 
+#include "stdint.h"
+
 /* Create the ConcentratorRadioTask and creates all TI-RTOS objects */
 void coordinatorTask_init(void);
 
+/* Returns the highest battery policy level reported by a known router, 0 when all run normally.
+ *
+ * address is set to the router reporting that level. */
+uint8_t CoordinatorTask_getPowerPolicy(uint8_t* address);
+
 #endif /* TASKS_COORDINATORTASK_H_ */
@@ -38,57 +38,105 @@
 #include <xdc/std.h>
 #include <xdc/runtime/System.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
 
 /* BIOS Header files */
 #include <ti/sysbios/BIOS.h>
 #include <ti/sysbios/knl/Task.h>
 #include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Semaphore.h>
 
 /* TI-RTOS Header files */
 #include <ti/drivers/PIN.h>
 #include <ti/drivers/UART.h>
-#include <ti/mw/display/Display.h>
-#include <ti/mw/display/DisplayExt.h>
+#include <ti/drivers/uart/UARTCC26XX.h>
 
 /* Example/Board Header files */
 #include "Board.h"
 
 #include <stdint.h>
 #include <GPS.h>
+#include "NmeaParser.h"
+#include "ByteRing.h"
+#include "GpsFix.h"
+#include "GpsConfig.h"
+#include "GpsMotion.h"
+#include "GpsPower.h"
+#include "NetworkTime.h"
+#include "easylink/EasyLink.h"
 
 
 #define TASKSTACKSIZE     768
-#define bSize   200
-#define packet  5
-#define time    6
-#define status  1
-#define LatDeg  2
-#define LongDeg 3
-#define DMM     6   //DMM degress and decimal minutes
+#define TASKPRIORITY      2     //Above the display task, so parsing never waits for the LCD
+#define bSize   64      //Bytes handed to the parser per pass
+#define chunkSize 32    //Bytes per UART read, the callback also fires early when the line goes idle
+#define ringSize  512   //Must be a power of two
 
+/* Receiver setup, the Adafruit Ultimate GPS uses an MTK chipset that starts at 9600 baud */
+#define GPS_RECEIVER            GpsConfig_Receiver_MTK
+#define GPS_INITIAL_BAUD_RATE   9600
+#define GPS_BAUD_RATE           115200
+#define GPS_FIX_INTERVAL_MS     200     //5 Hz, down to GPSCONFIG_MIN_FIX_INTERVAL_MS (10 Hz)
+#define GPS_GSV_DIVIDER         5
 
+/* Motion filter, positions closer than this to the last published one are dropped */
+#define GPS_MOTION_DISTANCE_M           10
+#define GPS_MOTION_SPEED_THRESHOLD      300     //3 km/h in 1/100 km/h
+#define GPS_STATIONARY_TIMEOUT_S        60
+#define GPS_STATIONARY_FIX_INTERVAL_MS  1000    //Fix rate while stationary
 
-struct pointer test;
+/* Duty cycling, the receiver sleeps in standby between fixes and hot starts when woken */
+#define GPS_STANDBY_INTERVAL_S          60      //0 keeps the receiver on all the time
+#define GPS_ACQUIRE_TIMEOUT_S           30
+#define GPS_FIXES_PER_WAKE              5
 
+/* Network time, delay from the fix epoch to the fix being parsed. Tune per receiver */
+#define GPS_TIME_LATENCY_MS             0
+
+
+
+struct pointer test;
 
-struct Buffer
-{
-    unsigned char rxBuffer[bSize];
-    char comparePacket[packet];
-    char Time[time];
-    char Status[status];
-    char NS[status];
-    char EW[status];
-
-    char LatitudeDeg[LatDeg];
-    char LatitudeDMM[DMM];               // DMM degrees and decimal minutes
-    char LongitudeDeg[LongDeg];
-    char LongitudeDMM[DMM];
-};
 
 Task_Struct task0Struct;
 Char task0Stack[TASKSTACKSIZE];
 
+static unsigned char rxBuffer[bSize];
+static unsigned char uartChunk[chunkSize];     //Filled by the UART driver, copied into the ring in the callback
+static uint8_t ringBuffer[ringSize];
+struct ByteRing gpsRing;                        //not static so you can see in ROV
+uint32_t gpsUartReads;                          //not static so you can see in ROV
+static Semaphore_Struct rxSemStruct;
+static Semaphore_Handle rxSemHandle;
+struct NmeaParser gpsParser;                    //not static so you can see in ROV
+
+static const struct GpsConfigParams gpsConfigParams = {
+    .receiver = GPS_RECEIVER,
+    .initialBaudRate = GPS_INITIAL_BAUD_RATE,
+    .baudRate = GPS_BAUD_RATE,
+    .fixIntervalMs = GPS_FIX_INTERVAL_MS,
+    .sentences = GPSFIX_SENTENCE_ALL,           //Everything GpsFix parses, the rest is turned off
+    .gsvDivider = GPS_GSV_DIVIDER,
+};
+
+static const struct GpsMotionParams gpsMotionParams = {
+    .distanceThresholdM = GPS_MOTION_DISTANCE_M,
+    .speedThreshold = GPS_MOTION_SPEED_THRESHOLD,
+    .stationaryTimeoutS = GPS_STATIONARY_TIMEOUT_S,
+    .fences = NULL,                             //No geofences by default
+    .numFences = 0,
+};
+
+static const struct GpsPowerParams gpsPowerParams = {
+    .standbyIntervalS = GPS_STANDBY_INTERVAL_S,
+    .acquireTimeoutS = GPS_ACQUIRE_TIMEOUT_S,
+    .fixesPerWake = GPS_FIXES_PER_WAKE,
+};
+
+/***** Prototypes *****/
+static void uartReadCallback(UART_Handle handle, void* buf, size_t count);
+
 /*
  * Application LED pin configuration table:
  *   - All LEDs board LEDs are off.
@@ -101,123 +149,71 @@ Char task0Stack[TASKSTACKSIZE];
  */
 Void GPS(UArg arg0, UArg arg1)
 {
-
-
-    struct Buffer p;
-    bool done = false;
-    bool comp = false;
-    //char ret;
-    int i = 0;
+    uint16_t count;
+    struct GpsFix fix;
+    uint32_t sequence;
+    uint32_t lastSequence = 0;
+    uint32_t lastValidFixes = 0;
+    uint32_t waitTicks = BIOS_WAIT_FOREVER;
+    uint8_t events;
+    bool newFix;
 
     //UART_CONFIG_WLEN_MASK = 0x08;
-   // unsigned char p.rxBuffer[200];
-    //int ret;
     UART_Handle handle;
     UART_Params uartParams;
-   Display_Params params;
-   Display_Params_init(&params);
-   params.lineClearMode = DISPLAY_CLEAR_BOTH;
-   Display_Handle hDisplayLcd = Display_open(Display_Type_LCD, &params);
 
 
     /* Create a UART with data processing off. */
     UART_Params_init(&uartParams);
     uartParams.writeDataMode = UART_DATA_BINARY;      //Not used, but Data is not processed mode
     uartParams.readDataMode = UART_DATA_BINARY;       //Data is not processed mode
+    uartParams.readMode = UART_MODE_CALLBACK;         //Never block the task on the UART, bytes are pushed into gpsRing
+    uartParams.readCallback = uartReadCallback;
     uartParams.readReturnMode = UART_RETURN_FULL;     //Receive return mode / UART_RETURN_FULL unblock/callback when buffer is full
     uartParams.readEcho = UART_ECHO_OFF;              //Echo received data back (false)
-    uartParams.baudRate = 9600;                       //Set the baud rate of the GPS
-    handle = UART_open(Board_UART0, &uartParams);     //
+    handle = GpsConfig_open(&gpsConfigParams, &uartParams);   //Configures the receiver and reopens UART0 at GPS_BAUD_RATE
 
     if (handle == NULL) {
         System_abort("Error opening the UART");
     }
 
-   //UART_write(uart, echoPrompt, sizeof(echoPrompt));
-
+    NmeaParser_init(&gpsParser, &GpsFix_parserCallbacks, NULL);
 
-     /*
-      *  ======== Parse ========
-      *  Simple function for parsing data
-      */
-   // th.t2 = (char*) malloc(1);
+    UART_control(handle, UARTCC26XX_CMD_RETURN_PARTIAL_ENABLE, NULL);   //Also call back when the line goes idle with a partial chunk
+    UART_read(handle, uartChunk, chunkSize);                            //Start receiving, the callback keeps the read going
+    GpsPower_init(&gpsPowerParams, handle, &gpsConfigParams);           //Times the first fix from here
 
-
-        test.t = (char*) malloc(1);
-        test.h = (char*) malloc(1);
     while (1)
     {
-       UART_read(handle, p.rxBuffer, 200);                                      //Read in data from UART into rxBuffer (100 byte buffer)
-       for(i = 0; i < 200; i++)                                                 //Iterate through buffer with for loop
+       Semaphore_pend(rxSemHandle, waitTicks);                                  //Wait for the UART callback to push new bytes, or for the duty cycle
+       while ((count = ByteRing_read(&gpsRing, rxBuffer, bSize)) != 0)          //Drain whatever arrived, partial sentences included
        {
-           if (p.rxBuffer[i] == '$')                                            //Start printing at the beginning of packet '$'
-           {
-               while(done == false)                                             //This while loop will iterate the buffer until a newline character is found
-               {
-                   comp = comparePackets(&p.rxBuffer, i);                       //Compares packets with "GPRMC", if true, then print to LCD
-                   if (comp == true)
-                   {
-                       Time(&p.rxBuffer, i);                                    //This function creates an array with data for TIME
-                       Status(&p.rxBuffer, i);
-                       Display_print5(hDisplayLcd, 1, 2, "Packet: %c%c%c%c%c",  //This function prints the packet type
-                       p.comparePacket[0], p.comparePacket[1],
-                       p.comparePacket[2], p.comparePacket[3],
-                       p.comparePacket[4]);
-
-                       Display_print2(hDisplayLcd, 3, 2, "HR: %c%c", p.Time[0], p.Time[1]); //This function prints the Hour
-                       Display_print2(hDisplayLcd, 4, 2, "MIN:%c%c", p.Time[2], p.Time[3]); //This function prints the Minutes
-                       Display_print2(hDisplayLcd, 5, 2, "SEC:%c%c", p.Time[4], p.Time[5]); //This function prints the Seconds
-                       Task_sleep(1000 * (1000/Clock_tickPeriod));              //Delay (1000 * (1000 / 48,000,000))
-
-                       Display_print1(hDisplayLcd, 6, 2, "Status: %c", p.Status[0]); //This function prints the Status
-                       if(p.Status[0] == 'A')                                   //Do not parse data if data is invalid! 'V' void
-                       {
-                           Latitude(&p.rxBuffer, i);
-                           Longitude(&p.rxBuffer, i);
-                           NorthSouth(&p.rxBuffer, i);
-                           EastWest(&p.rxBuffer, i);
-                           Display_print5(hDisplayLcd, 7, 0, "Lat:%c%c Long:%c%c%c", p.LatitudeDeg[0], //This function prints latitude/longitude degrees
-                           p.LatitudeDeg[1], p.LongitudeDeg[0], p.LongitudeDeg[1], p.LongitudeDeg[2]);
-
-
-                           Display_print2(hDisplayLcd, 8, 0, "N/S:%c   E/W:%c", p.NS[0], p.EW[0]); //This function prints NS/EW
-
-                           Display_print5(hDisplayLcd, 9, 0, "LatDMM:%c%c%c%c%c", p.LatitudeDMM[0], //This function prints DMM
-                                                    p.LatitudeDMM[1], p.LatitudeDMM[2], p.LatitudeDMM[3], p.LatitudeDMM[4]);
-
-                           Display_print5(hDisplayLcd, 10, 0, "LongDMM:%c%c%c%c%c", p.LongitudeDMM[0], //This function prints DMM
-                                                                               p.LongitudeDMM[1], p.LongitudeDMM[2], p.LongitudeDMM[3], p.LongitudeDMM[4]);
-                       //    Display_print2(hDisplayLcd, 11, 0, "LatM:%c LongM:%c ", p.LongitudeDMM[5], p.LatitudeDMM[5]); //This function prints NS/EW
-                       }
-                       else
-                       {
-                           Display_print0(hDisplayLcd, 7, 0, "Lat:NA Long:NA");            //Data not available!!
-                           Display_print0(hDisplayLcd, 8, 0, "N/S:NA  E/W:NA");
-                           Display_print0(hDisplayLcd, 9, 0, "LaDMM:NA");
-                           Display_print0(hDisplayLcd, 10, 0, "LoDMM:NA");
-                       //    Display_print0(hDisplayLcd, 11, 0, "LatM:NA LongM:NA");
-                       }
-                       comp = false;                                               //Reset comp variable
-                   }
-                   if (p.rxBuffer[i] == 10)                                     //If newline character is found, break loop and read in new data
-                   {
-                    done = true;                                                //Break while loop by setting done = to true
-                    i = 200;                                                    //Break for loop
-                   }
-                i++;                                                            //Increment i to iterate through buffer
-               }
-           }
-        done = false;                                                           //Reset done variable to false
+           NmeaParser_feed(&gpsParser, rxBuffer, count);                        //Sentences may start in one pass and end in the next
        }
 
-     //  Task_sleep(1000 * (1000/Clock_tickPeriod));
-       if (*test.t != 0)
+       newFix = false;
+       sequence = GpsFix_snapshot(&fix);
+       if (sequence != lastSequence)                                            //Only new fixes go through the motion filter
        {
-           Display_print3(hDisplayLcd, 11, 2, "T: %d H: %d%c", *test.t, *test.h, '%');
-      //     free(t.t);
+           lastSequence = sequence;
+           newFix = fix.valid && (fix.validFixes != lastValidFixes);
+           lastValidFixes = fix.validFixes;
+           if (newFix)                                                          //Routers timestamp their samples with this
+           {
+               NetworkTime_setReference(fix.secondsOfDay * 1000 + fix.milliseconds + GPS_TIME_LATENCY_MS, EasyLink_getAbsTime64());
+           }
+           events = GpsMotion_update(&fix);
+           if (events & GPSMOTION_EVENT_STATIONARY)                             //Not moving, let the receiver slow down
+           {
+               GpsConfig_setFixInterval(handle, &gpsConfigParams, GPS_STATIONARY_FIX_INTERVAL_MS);
+           }
+           else if (events & GPSMOTION_EVENT_MOVING)
+           {
+               GpsConfig_setFixInterval(handle, &gpsConfigParams, gpsConfigParams.fixIntervalMs);
+           }
        }
 
-
+       waitTicks = GpsPower_process(newFix);                                    //Standby after a fix, hot start on the interval
     }
 
 }
@@ -228,136 +224,35 @@ Void GPS(UArg arg0, UArg arg1)
 void GPS_init(void)
 {
     Task_Params taskParams;
+    Semaphore_Params semParams;
+
+    ByteRing_init(&gpsRing, ringBuffer, ringSize);
+    GpsFix_init();                                //Before BIOS_start, the display task may take a snapshot first
+    GpsMotion_init(&gpsMotionParams);
+
+    test.t = (char*) malloc(1);                   //Allocated before BIOS_start, the RF task writes to them from its callback
+    test.h = (char*) malloc(1);
+    *test.t = 0;
+    *test.h = 0;
 
     /* Construct BIOS objects */
+    Semaphore_Params_init(&semParams);
+    semParams.mode = Semaphore_Mode_BINARY;
+    Semaphore_construct(&rxSemStruct, 0, &semParams);
+    rxSemHandle = Semaphore_handle(&rxSemStruct);
+
     Task_Params_init(&taskParams);
     taskParams.stackSize = TASKSTACKSIZE;
     taskParams.stack = &task0Stack;
+    taskParams.priority = TASKPRIORITY;
     Task_construct(&task0Struct, (Task_FuncPtr)GPS, &taskParams, NULL);
 
 }
 
-bool comparePackets(struct Buffer * b, int k)
-{
-   char cmp[] = {'G','P','R','M','C'};
-   int i = 0;
-
-   for(i = 0; i < 5; i++)
-   {
-       k++;
-       b->comparePacket[i] = b->rxBuffer[k];
-   }
-   int y;
-   y = strncmp(cmp, b->comparePacket, 5);
-   if (y == 0)
-   {
-      return true;
-   }
-   return false;
-}
-
-void Time(struct Buffer * b, int k)
-{
-int i = 0;
-k += 7;
-while(b->comparePacket[k] != ',' && i != 7)
-{
-    b->Time[i] = b->rxBuffer[k];
-    i++;
-    k++;
-}
-}
-
-void Status(struct Buffer * b, int k)
-{
-int i = 0;
-k += 18;                                        //Point at byte element 18 on the packet
-while(b->comparePacket[k] != ',' && i < 1)
-{
-    b->Status[i] = b->rxBuffer[k];
-    i++;
-    k++;
-}
-}
-
-void Latitude(struct Buffer * b, int k)
-{
-int i = 0;
-int j = 0;
-k += 20;                                        //Point at byte element 18 on the packet
-while(b->comparePacket[k] != ',' && i < 10)
+static void uartReadCallback(UART_Handle handle, void* buf, size_t count)
 {
-    if (i < 2)
-    {
-    b->LatitudeDeg[i] = b->rxBuffer[k];
-    i++;
-    k++;
-
-    }
-    else if (2 <= i < 10)
-    {
-
-        if (b->rxBuffer[k] != '.')
-        {
-            b->LatitudeDMM[j] = b->rxBuffer[k];
-                i++;
-                j++;
-        }
-                k++;
-    }
+    gpsUartReads++;
+    ByteRing_write(&gpsRing, buf, count);       //Bytes that do not fit are counted in gpsRing.overruns
+    UART_read(handle, uartChunk, chunkSize);    //Rearm right away so no byte is missed while the task parses
+    Semaphore_post(rxSemHandle);
 }
-}
-
-
-void Longitude(struct Buffer * b, int k)
-{
-int i = 0;
-int j = 0;
-k += 32;                                        //Point at byte element 18 on the packet
-while(b->comparePacket[k] != ',' && i < 10)
-{
-    if (i < 3)
-    {
-    b->LongitudeDeg[i] = b->rxBuffer[k];
-    i++;
-    k++;
-
-    }
-    else if (3 <= i < 10)
-    {
-        if (b->rxBuffer[k] != '.')
-        {
-            b->LongitudeDMM[j] = b->rxBuffer[k];
-                i++;
-                j++;
-        }
-                k++;
-    }
-}
-}
-
-void NorthSouth(struct Buffer * b, int k)
-{
-int i = 0;
-k += 30;                                        //Point at byte element 18 on the packet
-while(b->comparePacket[k] != ',' && i < 1)
-{
-    b->NS[i] = b->rxBuffer[k];
-    i++;
-    k++;
-}
-}
-
-void EastWest(struct Buffer * b, int k)
-{
-int i = 0;
-k += 43;                                        //Point at byte element i + 43 on the packet
-while(b->comparePacket[k] != ',' && i < 1)
-{
-    b->EW[i] = b->rxBuffer[k];
-    i++;
-    k++;
-}
-}
-
-
@@ -41,4 +41,8 @@ char * rssi;            //relative received signal strength
 
 };
 
+extern struct pointer test;     //Latest router readings, shown by the GPS display
+
+void GPS_init(void);
+
 #endif /* GPS_H_ */
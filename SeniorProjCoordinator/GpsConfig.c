@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "GpsConfig.h"
+#include "GpsFix.h"
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include <ti/drivers/UART.h>
+
+#include <string.h>
+
+/* Board Header files */
+#include "Board.h"
+
+
+/***** Defines *****/
+/* Time for the baud rate command to leave the UART and for the receiver to switch */
+#define GPSCONFIG_BAUD_SWITCH_MS    100
+
+#define GPSCONFIG_MAX_COMMAND_LENGTH 64
+
+/* PMTK314 output rates, one field per sentence type */
+#define PMTK_SENTENCE_FIELDS        19
+#define PMTK_FIELD_GLL              0
+#define PMTK_FIELD_RMC              1
+#define PMTK_FIELD_VTG              2
+#define PMTK_FIELD_GGA              3
+#define PMTK_FIELD_GSA              4
+#define PMTK_FIELD_GSV              5
+
+#define UBX_SYNC_1                  0xB5
+#define UBX_SYNC_2                  0x62
+#define UBX_CLASS_CFG               0x06
+#define UBX_CFG_PRT                 0x00
+#define UBX_CFG_MSG                 0x01
+#define UBX_CFG_RATE                0x08
+#define UBX_CLASS_RXM               0x02
+#define UBX_RXM_PMREQ               0x41
+#define UBX_PMREQ_BACKUP            0x00000002
+#define UBX_WAKE_BYTES              8       /* Any UART activity wakes the receiver */
+#define UBX_CLASS_NMEA              0xF0
+#define UBX_PORT_UART1              1
+#define UBX_PORT_MODE_8N1           0x000008D0
+#define UBX_PROTO_UBX               0x0001
+#define UBX_PROTO_NMEA              0x0002
+#define UBX_TIME_REF_GPS            1
+#define UBX_NMEA_ID_COUNT           11      /* GGA 0x00 up to DTM 0x0A */
+#define UBX_NMEA_ID_GGA             0x00
+#define UBX_NMEA_ID_GSA             0x02
+#define UBX_NMEA_ID_GSV             0x03
+#define UBX_NMEA_ID_RMC             0x04
+#define UBX_NMEA_ID_VTG             0x05
+
+#define GpsConfig_ms_To_Ticks(ms) ((uint32_t)(((uint64_t)(ms) * 1000) / Clock_tickPeriod))
+
+
+/***** Prototypes *****/
+static void sendBaudRate(UART_Handle handle, const struct GpsConfigParams* params);
+static void sendSentences(UART_Handle handle, const struct GpsConfigParams* params);
+static void sendFixInterval(UART_Handle handle, const struct GpsConfigParams* params, uint16_t intervalMs);
+static uint8_t sentenceRate(const struct GpsConfigParams* params, uint16_t sentence);
+static void sendPmtk(UART_Handle handle, const char* body);
+static void sendUbx(UART_Handle handle, uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t length);
+static char* appendString(char* dst, const char* src);
+static char* appendUint(char* dst, uint32_t value);
+static void putLe16(uint8_t* dst, uint16_t value);
+static void putLe32(uint8_t* dst, uint32_t value);
+
+
+/***** Function definitions *****/
+UART_Handle GpsConfig_open(const struct GpsConfigParams* params, UART_Params* uartParams)
+{
+    UART_Handle handle;
+
+    /* Switch the baud rate first, at the rate the receiver starts with */
+    uartParams->baudRate = params->initialBaudRate;
+    handle = UART_open(Board_UART0, uartParams);
+    if (handle == NULL)
+    {
+        return NULL;
+    }
+    if (params->baudRate != params->initialBaudRate)
+    {
+        sendBaudRate(handle, params);
+        Task_sleep(GpsConfig_ms_To_Ticks(GPSCONFIG_BAUD_SWITCH_MS));
+
+        UART_close(handle);
+        uartParams->baudRate = params->baudRate;
+        handle = UART_open(Board_UART0, uartParams);
+        if (handle == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    /* Drop the sentences we do not parse before raising the fix rate */
+    sendSentences(handle, params);
+    sendFixInterval(handle, params, params->fixIntervalMs);
+
+    return handle;
+}
+
+void GpsConfig_setFixInterval(UART_Handle handle, const struct GpsConfigParams* params, uint16_t fixIntervalMs)
+{
+    sendFixInterval(handle, params, fixIntervalMs);
+}
+
+static void sendBaudRate(UART_Handle handle, const struct GpsConfigParams* params)
+{
+    char body[GPSCONFIG_MAX_COMMAND_LENGTH];
+    uint8_t payload[20];
+
+    if (params->receiver == GpsConfig_Receiver_MTK)
+    {
+        appendUint(appendString(body, "PMTK251,"), params->baudRate);
+        sendPmtk(handle, body);
+    }
+    else
+    {
+        memset(payload, 0, sizeof(payload));
+        payload[0] = UBX_PORT_UART1;
+        putLe32(&payload[4], UBX_PORT_MODE_8N1);
+        putLe32(&payload[8], params->baudRate);
+        putLe16(&payload[12], UBX_PROTO_UBX | UBX_PROTO_NMEA);
+        putLe16(&payload[14], UBX_PROTO_NMEA);
+        sendUbx(handle, UBX_CLASS_CFG, UBX_CFG_PRT, payload, sizeof(payload));
+    }
+}
+
+static void sendSentences(UART_Handle handle, const struct GpsConfigParams* params)
+{
+    char body[GPSCONFIG_MAX_COMMAND_LENGTH];
+    char* pos;
+    uint8_t rates[PMTK_SENTENCE_FIELDS];
+    uint8_t payload[3];
+    uint8_t i;
+
+    if (params->receiver == GpsConfig_Receiver_MTK)
+    {
+        memset(rates, 0, sizeof(rates));
+        rates[PMTK_FIELD_RMC] = sentenceRate(params, GPSFIX_SENTENCE_RMC);
+        rates[PMTK_FIELD_VTG] = sentenceRate(params, GPSFIX_SENTENCE_VTG);
+        rates[PMTK_FIELD_GGA] = sentenceRate(params, GPSFIX_SENTENCE_GGA);
+        rates[PMTK_FIELD_GSA] = sentenceRate(params, GPSFIX_SENTENCE_GSA);
+        rates[PMTK_FIELD_GSV] = sentenceRate(params, GPSFIX_SENTENCE_GSV);
+
+        pos = appendString(body, "PMTK314");
+        for (i = 0; i < PMTK_SENTENCE_FIELDS; i++)
+        {
+            pos = appendUint(appendString(pos, ","), rates[i]);
+        }
+        sendPmtk(handle, body);
+    }
+    else
+    {
+        /* One CFG-MSG per NMEA message, anything not listed is disabled */
+        for (i = 0; i < UBX_NMEA_ID_COUNT; i++)
+        {
+            payload[0] = UBX_CLASS_NMEA;
+            payload[1] = i;
+            switch (i)
+            {
+            case UBX_NMEA_ID_GGA:
+                payload[2] = sentenceRate(params, GPSFIX_SENTENCE_GGA);
+                break;
+            case UBX_NMEA_ID_GSA:
+                payload[2] = sentenceRate(params, GPSFIX_SENTENCE_GSA);
+                break;
+            case UBX_NMEA_ID_GSV:
+                payload[2] = sentenceRate(params, GPSFIX_SENTENCE_GSV);
+                break;
+            case UBX_NMEA_ID_RMC:
+                payload[2] = sentenceRate(params, GPSFIX_SENTENCE_RMC);
+                break;
+            case UBX_NMEA_ID_VTG:
+                payload[2] = sentenceRate(params, GPSFIX_SENTENCE_VTG);
+                break;
+            default:
+                payload[2] = 0;
+                break;
+            }
+            sendUbx(handle, UBX_CLASS_CFG, UBX_CFG_MSG, payload, sizeof(payload));
+        }
+    }
+}
+
+static void sendFixInterval(UART_Handle handle, const struct GpsConfigParams* params, uint16_t intervalMs)
+{
+    char body[GPSCONFIG_MAX_COMMAND_LENGTH];
+    uint8_t payload[6];
+
+    if (intervalMs < GPSCONFIG_MIN_FIX_INTERVAL_MS)
+    {
+        intervalMs = GPSCONFIG_MIN_FIX_INTERVAL_MS;
+    }
+    else if (intervalMs > GPSCONFIG_MAX_FIX_INTERVAL_MS)
+    {
+        intervalMs = GPSCONFIG_MAX_FIX_INTERVAL_MS;
+    }
+
+    if (params->receiver == GpsConfig_Receiver_MTK)
+    {
+        /* PMTK220 sets the output rate, PMTK300 the position fix rate */
+        appendUint(appendString(body, "PMTK220,"), intervalMs);
+        sendPmtk(handle, body);
+        appendString(appendUint(appendString(body, "PMTK300,"), intervalMs), ",0,0,0,0");
+        sendPmtk(handle, body);
+    }
+    else
+    {
+        putLe16(&payload[0], intervalMs);
+        putLe16(&payload[2], 1);                /* One navigation solution per measurement */
+        putLe16(&payload[4], UBX_TIME_REF_GPS);
+        sendUbx(handle, UBX_CLASS_CFG, UBX_CFG_RATE, payload, sizeof(payload));
+    }
+}
+
+void GpsConfig_standby(UART_Handle handle, const struct GpsConfigParams* params)
+{
+    uint8_t payload[8];
+
+    if (params->receiver == GpsConfig_Receiver_MTK)
+    {
+        sendPmtk(handle, "PMTK161,0");
+    }
+    else
+    {
+        /* Duration 0 keeps it in backup until woken over the UART */
+        memset(payload, 0, sizeof(payload));
+        putLe32(&payload[4], UBX_PMREQ_BACKUP);
+        sendUbx(handle, UBX_CLASS_RXM, UBX_RXM_PMREQ, payload, sizeof(payload));
+    }
+}
+
+void GpsConfig_wake(UART_Handle handle, const struct GpsConfigParams* params)
+{
+    uint8_t wake[UBX_WAKE_BYTES];
+
+    if (params->receiver == GpsConfig_Receiver_MTK)
+    {
+        /* Any command wakes it, PMTK000 is the test command */
+        sendPmtk(handle, "PMTK000");
+    }
+    else
+    {
+        memset(wake, 0xFF, sizeof(wake));
+        UART_write(handle, wake, sizeof(wake));
+    }
+}
+
+static uint8_t sentenceRate(const struct GpsConfigParams* params, uint16_t sentence)
+{
+    if (!(params->sentences & sentence))
+    {
+        return 0;
+    }
+    if ((sentence == GPSFIX_SENTENCE_GSV) && (params->gsvDivider > 1))
+    {
+        return params->gsvDivider;
+    }
+    return 1;
+}
+
+static void sendPmtk(UART_Handle handle, const char* body)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char trailer[5];
+    uint8_t checksum = 0;
+    const char* c;
+
+    for (c = body; *c != '\0'; c++)
+    {
+        checksum ^= (uint8_t)*c;
+    }
+    trailer[0] = '*';
+    trailer[1] = hex[checksum >> 4];
+    trailer[2] = hex[checksum & 0x0F];
+    trailer[3] = '\r';
+    trailer[4] = '\n';
+
+    UART_write(handle, "$", 1);
+    UART_write(handle, body, strlen(body));
+    UART_write(handle, trailer, sizeof(trailer));
+}
+
+static void sendUbx(UART_Handle handle, uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t length)
+{
+    uint8_t header[6];
+    uint8_t checksum[2] = { 0, 0 };
+    uint16_t i;
+
+    header[0] = UBX_SYNC_1;
+    header[1] = UBX_SYNC_2;
+    header[2] = msgClass;
+    header[3] = msgId;
+    putLe16(&header[4], length);
+
+    /* 8-bit Fletcher checksum over class, id, length and payload */
+    for (i = 2; i < sizeof(header); i++)
+    {
+        checksum[0] += header[i];
+        checksum[1] += checksum[0];
+    }
+    for (i = 0; i < length; i++)
+    {
+        checksum[0] += payload[i];
+        checksum[1] += checksum[0];
+    }
+
+    UART_write(handle, header, sizeof(header));
+    UART_write(handle, payload, length);
+    UART_write(handle, checksum, sizeof(checksum));
+}
+
+static char* appendString(char* dst, const char* src)
+{
+    while (*src != '\0')
+    {
+        *dst++ = *src++;
+    }
+    *dst = '\0';
+    return dst;
+}
+
+static char* appendUint(char* dst, uint32_t value)
+{
+    char digits[10];
+    uint8_t count = 0;
+
+    do
+    {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0)
+    {
+        *dst++ = digits[--count];
+    }
+    *dst = '\0';
+    return dst;
+}
+
+static void putLe16(uint8_t* dst, uint16_t value)
+{
+    dst[0] = value & 0xFF;
+    dst[1] = value >> 8;
+}
+
+static void putLe32(uint8_t* dst, uint32_t value)
+{
+    putLe16(&dst[0], value & 0xFFFF);
+    putLe16(&dst[2], value >> 16);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPSCONFIG_H_
+#define GPSCONFIG_H_
+
+#include "stdint.h"
+#include <ti/drivers/UART.h>
+
+/* Command set understood by the receiver */
+enum GpsConfigReceiver {
+    GpsConfig_Receiver_MTK,     /* PMTK sentences, e.g. MT3339 on the Adafruit Ultimate GPS */
+    GpsConfig_Receiver_UBX,     /* u-blox binary protocol */
+};
+
+#define GPSCONFIG_MIN_FIX_INTERVAL_MS 100   /* 10 Hz */
+#define GPSCONFIG_MAX_FIX_INTERVAL_MS 10000
+
+struct GpsConfigParams {
+    enum GpsConfigReceiver receiver;
+    uint32_t initialBaudRate;   /* Rate the receiver uses after power up */
+    uint32_t baudRate;          /* Rate to switch to */
+    uint16_t fixIntervalMs;     /* Time between fixes, GPSCONFIG_MIN_FIX_INTERVAL_MS or more */
+    uint16_t sentences;         /* GPSFIX_SENTENCE_* to keep, all others are disabled */
+    uint8_t gsvDivider;         /* GSV is only sent every n'th fix, it is long and changes slowly */
+};
+
+/* Configures the receiver and opens UART0 at the new rate.
+ *
+ * The baud rate command is sent at initialBaudRate first, everything else at baudRate, so a
+ * receiver that kept its rate from an earlier run is configured as well. uartParams is used for
+ * the final open, its baudRate is overwritten. Acknowledgements are not checked. Must be called
+ * from a task. Returns NULL when UART0 could not be opened. */
+UART_Handle GpsConfig_open(const struct GpsConfigParams* params, UART_Params* uartParams);
+
+/* Changes the fix interval of a receiver opened with GpsConfig_open, e.g. to back off while
+ * the position does not change. Must be called from a task. */
+void GpsConfig_setFixInterval(UART_Handle handle, const struct GpsConfigParams* params, uint16_t fixIntervalMs);
+
+/* Puts the receiver into standby. It keeps its almanac, ephemeris and time, so it hot starts
+ * when woken again with GpsConfig_wake. */
+void GpsConfig_standby(UART_Handle handle, const struct GpsConfigParams* params);
+
+/* Wakes the receiver from standby */
+void GpsConfig_wake(UART_Handle handle, const struct GpsConfigParams* params);
+
+#endif /* GPSCONFIG_H_ */
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "GpsDisplay.h"
+#include "GpsFix.h"
+#include "GpsMotion.h"
+#include "CoordinatorTask.h"
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include <ti/mw/display/Display.h>
+#include <ti/mw/display/DisplayExt.h>
+
+#include <string.h>
+#include <GPS.h>
+
+
+/***** Defines *****/
+#define GPSDISPLAY_TASK_STACK_SIZE 768
+#define GPSDISPLAY_TASK_PRIORITY   1       /* Below the GPS parser, the LCD only gets idle time */
+
+#define GpsDisplay_ms_To_Ticks(ms) ((uint32_t)(((uint64_t)(ms) * 1000) / Clock_tickPeriod))
+
+
+/***** Variable declarations *****/
+static Task_Params gpsDisplayTaskParams;
+Task_Struct gpsDisplayTask;    /* not static so you can see in ROV */
+static uint8_t gpsDisplayTaskStack[GPSDISPLAY_TASK_STACK_SIZE];
+
+static Display_Handle hDisplayLcd;
+static volatile uint32_t refreshTicks;
+static struct GpsFix shown;             /* What is on the LCD right now */
+static struct GpsMotionState shownMotion;
+static char shownT;
+static char shownH;
+static uint8_t shownPowerPolicy;
+static uint8_t shownPowerAddress;
+uint32_t gpsDisplayRedraws;             /* not static so you can see in ROV */
+
+
+/***** Prototypes *****/
+static void gpsDisplayTaskFunction(UArg arg0, UArg arg1);
+static void renderFix(const struct GpsFix* p, bool force);
+static void renderCoordinate(uint8_t line, const char* label, int32_t microDegrees);
+static void renderMotion(const struct GpsMotionState* m, bool force);
+static void renderSensor(bool force);
+static void renderPowerPolicy(bool force);
+static uint8_t satellitesInView(const struct GpsFix* p);
+
+
+/***** Function definitions *****/
+void GpsDisplay_init(uint32_t refreshMs)
+{
+    GpsDisplay_setRefreshPeriod(refreshMs);
+
+    /* Create the display task */
+    Task_Params_init(&gpsDisplayTaskParams);
+    gpsDisplayTaskParams.stackSize = GPSDISPLAY_TASK_STACK_SIZE;
+    gpsDisplayTaskParams.priority = GPSDISPLAY_TASK_PRIORITY;
+    gpsDisplayTaskParams.stack = &gpsDisplayTaskStack;
+    Task_construct(&gpsDisplayTask, gpsDisplayTaskFunction, &gpsDisplayTaskParams, NULL);
+}
+
+void GpsDisplay_setRefreshPeriod(uint32_t refreshMs)
+{
+    refreshTicks = GpsDisplay_ms_To_Ticks(refreshMs);
+}
+
+static void gpsDisplayTaskFunction(UArg arg0, UArg arg1)
+{
+    struct GpsFix p;
+    struct GpsMotionState m;
+    uint32_t sequence;
+    uint32_t shownSequence = 0;
+    uint32_t shownMotionSequence = 0;
+    bool first = true;
+
+    Display_Params params;
+    Display_Params_init(&params);
+    params.lineClearMode = DISPLAY_CLEAR_BOTH;
+    hDisplayLcd = Display_open(Display_Type_LCD, &params);
+
+    while (1)
+    {
+        sequence = GpsFix_snapshot(&p);
+        if (first || (sequence != shownSequence))
+        {
+            renderFix(&p, first);
+            shownSequence = sequence;
+        }
+        sequence = GpsMotion_snapshot(&m);
+        if (first || (sequence != shownMotionSequence))
+        {
+            renderMotion(&m, first);
+            shownMotionSequence = sequence;
+        }
+        renderSensor(first);
+        renderPowerPolicy(first);
+        first = false;
+
+        Task_sleep(refreshTicks);
+    }
+}
+
+static void renderFix(const struct GpsFix* p, bool force)
+{
+    bool validChanged = force || (p->valid != shown.valid);
+
+    if (force || (p->satellitesUsed != shown.satellitesUsed) ||
+        (satellitesInView(p) != satellitesInView(&shown)) || (p->fixMode != shown.fixMode))
+    {
+        Display_print3(hDisplayLcd, 1, 2, "Sats:%d/%d Fix:%dD", p->satellitesUsed, satellitesInView(p), p->fixMode);
+        gpsDisplayRedraws++;
+    }
+
+    /* Mostly only the seconds change, so the time is redrawn field by field */
+    if (force || ((p->secondsOfDay / 3600) != (shown.secondsOfDay / 3600)))
+    {
+        Display_print1(hDisplayLcd, 3, 2, "HR: %02d", p->secondsOfDay / 3600);
+        gpsDisplayRedraws++;
+    }
+    if (force || ((p->secondsOfDay / 60) != (shown.secondsOfDay / 60)))
+    {
+        Display_print1(hDisplayLcd, 4, 2, "MIN:%02d", (p->secondsOfDay / 60) % 60);
+        gpsDisplayRedraws++;
+    }
+    if (force || (p->secondsOfDay != shown.secondsOfDay))
+    {
+        Display_print1(hDisplayLcd, 5, 2, "SEC:%02d", p->secondsOfDay % 60);
+        gpsDisplayRedraws++;
+    }
+
+    if (validChanged)
+    {
+        Display_print1(hDisplayLcd, 6, 2, "Status: %c", p->valid ? 'A' : 'V');
+        gpsDisplayRedraws++;
+    }
+
+    if (p->valid)
+    {
+        if (validChanged || (p->hdop != shown.hdop))
+        {
+            Display_print2(hDisplayLcd, 12, 0, "HDOP:%d.%02d", p->hdop / 100, p->hdop % 100);
+            gpsDisplayRedraws++;
+        }
+        if (validChanged || ((p->altitudeDm / 10) != (shown.altitudeDm / 10)) ||
+            ((p->speedKmh / 100) != (shown.speedKmh / 100)))
+        {
+            Display_print2(hDisplayLcd, 13, 0, "Alt:%dm Spd:%dkm/h", p->altitudeDm / 10, p->speedKmh / 100);
+            gpsDisplayRedraws++;
+        }
+    }
+    else if (validChanged)
+    {
+        /* Data not available, only drawn once when the fix is lost */
+        Display_print0(hDisplayLcd, 12, 0, "HDOP:NA");
+        Display_print0(hDisplayLcd, 13, 0, "Alt:NA Spd:NA");
+        gpsDisplayRedraws += 2;
+    }
+
+    shown = *p;
+}
+
+static void renderMotion(const struct GpsMotionState* m, bool force)
+{
+    /* The position only changes on significant moves, jitter does not cause redraws */
+    if (!m->hasPosition)
+    {
+        if (force)
+        {
+            Display_print0(hDisplayLcd, 7, 0, "Lat:NA");
+            Display_print0(hDisplayLcd, 8, 0, "Lon:NA");
+            gpsDisplayRedraws += 2;
+        }
+    }
+    else
+    {
+        if (force || !shownMotion.hasPosition || (m->position.latitude != shownMotion.position.latitude))
+        {
+            renderCoordinate(7, "Lat:", m->position.latitude);
+        }
+        if (force || !shownMotion.hasPosition || (m->position.longitude != shownMotion.position.longitude))
+        {
+            renderCoordinate(8, "Lon:", m->position.longitude);
+        }
+    }
+
+    if (force || (m->stationary != shownMotion.stationary) || (m->insideFences != shownMotion.insideFences))
+    {
+        Display_print2(hDisplayLcd, 14, 0, "%s Fence:%x", m->stationary ? "Still " : "Moving", m->insideFences);
+        gpsDisplayRedraws++;
+    }
+
+    shownMotion = *m;
+}
+
+static void renderCoordinate(uint8_t line, const char* label, int32_t microDegrees)
+{
+    uint32_t magnitude = (microDegrees < 0) ? -microDegrees : microDegrees;
+
+    /* Decimal degrees, e.g. "Lat:-48.117300" */
+    Display_print4(hDisplayLcd, line, 0, "%s%c%d.%06d", label, (microDegrees < 0) ? '-' : ' ',
+                   magnitude / 1000000, magnitude % 1000000);
+    gpsDisplayRedraws++;
+}
+
+static void renderSensor(bool force)
+{
+    char t = *test.t;
+    char h = *test.h;
+
+    /* Latest temperature and humidity received from a router */
+    if ((t != 0) && (force || (t != shownT) || (h != shownH)))
+    {
+        Display_print3(hDisplayLcd, 11, 2, "T: %d H: %d%c", t, h, '%');
+        gpsDisplayRedraws++;
+        shownT = t;
+        shownH = h;
+    }
+}
+
+static void renderPowerPolicy(bool force)
+{
+    uint8_t address;
+    uint8_t powerPolicy = CoordinatorTask_getPowerPolicy(&address);
+
+    /* Router with the lowest battery, 1 is conserve and 2 critical */
+    if (force || (powerPolicy != shownPowerPolicy) || (address != shownPowerAddress))
+    {
+        if (powerPolicy == 0)
+        {
+            Display_print0(hDisplayLcd, 10, 2, "Batt: OK");
+        }
+        else
+        {
+            Display_print2(hDisplayLcd, 10, 2, "Batt: %x Lvl:%d", address, powerPolicy);
+        }
+        gpsDisplayRedraws++;
+        shownPowerPolicy = powerPolicy;
+        shownPowerAddress = address;
+    }
+}
+
+static uint8_t satellitesInView(const struct GpsFix* p)
+{
+    return p->satellitesInView[GpsFix_Talker_GPS] + p->satellitesInView[GpsFix_Talker_GLONASS] +
+           p->satellitesInView[GpsFix_Talker_Combined];
+}
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "GpsFix.h"
+
+#include <string.h>
+
+
+/***** Defines *****/
+#define GPSFIX_ADDRESS_LENGTH   5       /* Talker and sentence ID, e.g. "GPRMC" */
+#define GPSFIX_KNOTS_TO_KMH     1852    /* 1 knot is 1.852 km/h */
+#define GPSFIX_MICRODEGREES     1000000
+#define GPSFIX_MINUTE_DECIMALS  5       /* Receivers send 4 or 5 decimals of a minute */
+#define GPSFIX_MINUTE_SCALE     100000
+
+
+/***** Type declarations *****/
+typedef void (*GpsFix_FieldFxn)(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length);
+
+struct GpsFixSentence {
+    char id[3];
+    uint16_t bit;
+    GpsFix_FieldFxn field;
+};
+
+
+/***** Prototypes *****/
+static void sentenceStart(void* arg);
+static bool field(void* arg, uint8_t index, const char* text, uint8_t length);
+static void sentenceEnd(void* arg, bool valid);
+static bool lookupTalker(const char* text, enum GpsFixTalker* talker);
+static const struct GpsFixSentence* lookupSentence(const char* id);
+static void rmcField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length);
+static void ggaField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length);
+static void gsaField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length);
+static void vtgField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length);
+static void gsvField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length);
+static void parseTime(struct GpsFix* fix, const char* text);
+static bool parseCoordinate(int32_t* dst, const char* text);
+static void applyHemisphere(int32_t* coordinate, const char* text, uint8_t length, char negative);
+static void parseU8(uint8_t* dst, const char* text);
+static void parseU16(uint16_t* dst, const char* text, uint8_t decimals);
+
+
+/***** Variable declarations *****/
+static const struct GpsFixSentence sentenceTable[] = {
+    { "RMC", GPSFIX_SENTENCE_RMC, rmcField },
+    { "GGA", GPSFIX_SENTENCE_GGA, ggaField },
+    { "GSA", GPSFIX_SENTENCE_GSA, gsaField },
+    { "VTG", GPSFIX_SENTENCE_VTG, vtgField },
+    { "GSV", GPSFIX_SENTENCE_GSV, gsvField },
+};
+
+const struct NmeaParserCallbacks GpsFix_parserCallbacks = {
+    .sentenceStart = sentenceStart,
+    .field = field,
+    .sentenceEnd = sentenceEnd,
+};
+
+struct GpsFix gpsFix;           /* not static so you can see in ROV */
+static volatile uint32_t gpsFixSequence;    /* Odd while gpsFix is being written */
+static struct GpsFix staged;    /* gpsFix plus the fields of the sentence being parsed */
+static const struct GpsFixSentence* stagedSentence;
+static enum GpsFixTalker stagedTalker;
+static bool stagedLatitude;     /* The hemisphere is only applied to coordinates of the same sentence */
+static bool stagedLongitude;
+
+
+/***** Function definitions *****/
+void GpsFix_init(void)
+{
+    memset(&gpsFix, 0, sizeof(gpsFix));
+}
+
+uint32_t GpsFix_snapshot(struct GpsFix* fix)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = gpsFixSequence;
+        *fix = *(volatile struct GpsFix*)&gpsFix;   //Volatile so the copy stays between the reads of the sequence
+    } while ((sequence & 1) || (sequence != gpsFixSequence));
+
+    return sequence;
+}
+
+static void sentenceStart(void* arg)
+{
+    stagedSentence = NULL;
+}
+
+static bool field(void* arg, uint8_t index, const char* text, uint8_t length)
+{
+    if (index == 0)
+    {
+        /* Unknown sentences are dropped here, before any other field is looked at */
+        if ((length != GPSFIX_ADDRESS_LENGTH) || !lookupTalker(text, &stagedTalker))
+        {
+            return false;
+        }
+        stagedSentence = lookupSentence(&text[2]);
+        if (stagedSentence == NULL)
+        {
+            return false;
+        }
+
+        /* Start from the current fix so fields of other sentences are kept */
+        staged = gpsFix;
+        stagedLatitude = false;
+        stagedLongitude = false;
+        return true;
+    }
+
+    stagedSentence->field(&staged, index, text, length);
+    return true;
+}
+
+static void sentenceEnd(void* arg, bool valid)
+{
+    if (valid && (stagedSentence != NULL))
+    {
+        staged.sentences |= stagedSentence->bit;
+        if ((stagedSentence->bit == GPSFIX_SENTENCE_RMC) && staged.valid)
+        {
+            staged.validFixes++;
+        }
+
+        /* The copy is volatile like the sequence, so the compiler keeps it between the increments */
+        gpsFixSequence++;
+        *(volatile struct GpsFix*)&gpsFix = staged;
+        gpsFixSequence++;
+    }
+    stagedSentence = NULL;
+}
+
+static bool lookupTalker(const char* text, enum GpsFixTalker* talker)
+{
+    if (text[0] != 'G')
+    {
+        return false;
+    }
+
+    switch (text[1])
+    {
+    case 'P':
+        *talker = GpsFix_Talker_GPS;
+        return true;
+    case 'L':
+        *talker = GpsFix_Talker_GLONASS;
+        return true;
+    case 'N':
+        *talker = GpsFix_Talker_Combined;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static const struct GpsFixSentence* lookupSentence(const char* id)
+{
+    uint8_t i;
+
+    for (i = 0; i < (sizeof(sentenceTable) / sizeof(sentenceTable[0])); i++)
+    {
+        if (memcmp(sentenceTable[i].id, id, sizeof(sentenceTable[i].id)) == 0)
+        {
+            return &sentenceTable[i];
+        }
+    }
+    return NULL;
+}
+
+/* $GPRMC,hhmmss.ss,A,ddmm.mmmm,N,dddmm.mmmm,E,knots,course,ddmmyy,... */
+static void rmcField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length)
+{
+    int32_t value;
+
+    switch (index)
+    {
+    case 1:
+        parseTime(fix, text);
+        break;
+    case 2:
+        fix->valid = (length > 0) && (text[0] == 'A');
+        break;
+    case 3:
+        stagedLatitude = parseCoordinate(&fix->latitude, text);
+        break;
+    case 4:
+        if (stagedLatitude)
+        {
+            applyHemisphere(&fix->latitude, text, length, 'S');
+        }
+        break;
+    case 5:
+        stagedLongitude = parseCoordinate(&fix->longitude, text);
+        break;
+    case 6:
+        if (stagedLongitude)
+        {
+            applyHemisphere(&fix->longitude, text, length, 'W');
+        }
+        break;
+    case 7:
+        if (NmeaParser_parseFixed(text, 2, &value) && (value >= 0))
+        {
+            fix->speedKmh = ((uint32_t)value * GPSFIX_KNOTS_TO_KMH) / 1000;
+        }
+        break;
+    case 8:
+        parseU16(&fix->course, text, 2);
+        break;
+    default:
+        break;
+    }
+}
+
+/* $GPGGA,hhmmss.ss,lat,N,lon,E,quality,sats,hdop,altitude,M,geoid,M,... */
+static void ggaField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length)
+{
+    int32_t value;
+
+    switch (index)
+    {
+    case 6:
+        parseU8(&fix->quality, text);
+        break;
+    case 7:
+        parseU8(&fix->satellitesUsed, text);
+        break;
+    case 8:
+        parseU16(&fix->hdop, text, 2);
+        break;
+    case 9:
+        if (NmeaParser_parseFixed(text, 1, &value))
+        {
+            fix->altitudeDm = value;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* $GPGSA,mode,fix,sv1,...,sv12,pdop,hdop,vdop */
+static void gsaField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length)
+{
+    switch (index)
+    {
+    case 2:
+        parseU8(&fix->fixMode, text);
+        break;
+    case 15:
+        parseU16(&fix->pdop, text, 2);
+        break;
+    case 16:
+        parseU16(&fix->hdop, text, 2);
+        break;
+    case 17:
+        parseU16(&fix->vdop, text, 2);
+        break;
+    default:
+        break;
+    }
+}
+
+/* $GPVTG,course,T,course,M,knots,N,kmh,K,... */
+static void vtgField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length)
+{
+    int32_t value;
+
+    switch (index)
+    {
+    case 1:
+        parseU16(&fix->course, text, 2);
+        break;
+    case 7:
+        if (NmeaParser_parseFixed(text, 2, &value) && (value >= 0))
+        {
+            fix->speedKmh = (uint32_t)value;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* $GPGSV,messages,message,inView,... */
+static void gsvField(struct GpsFix* fix, uint8_t index, const char* text, uint8_t length)
+{
+    if (index == 3)
+    {
+        parseU8(&fix->satellitesInView[stagedTalker], text);
+    }
+}
+
+static void parseTime(struct GpsFix* fix, const char* text)
+{
+    int32_t value;
+    uint32_t hours;
+    uint32_t minutes;
+    uint32_t seconds;
+
+    /* hhmmss.sss as an integer in milliseconds, e.g. 123519500 */
+    if (!NmeaParser_parseFixed(text, 3, &value) || (value < 0))
+    {
+        return;
+    }
+
+    hours = value / 10000000;
+    minutes = (value / 100000) % 100;
+    seconds = (value / 1000) % 100;
+    if ((hours > 23) || (minutes > 59) || (seconds > 60))
+    {
+        return;
+    }
+
+    fix->secondsOfDay = (hours * 3600) + (minutes * 60) + seconds;
+    fix->milliseconds = value % 1000;
+}
+
+static bool parseCoordinate(int32_t* dst, const char* text)
+{
+    int32_t value;
+    int32_t degrees;
+    int32_t minutes;
+
+    /* (d)ddmm.mmmmm scaled by 10^5 is at most 18000.00000, which fits in an int32 */
+    if (!NmeaParser_parseFixed(text, GPSFIX_MINUTE_DECIMALS, &value) || (value < 0))
+    {
+        return false;
+    }
+
+    degrees = value / (100 * GPSFIX_MINUTE_SCALE);
+    minutes = value % (100 * GPSFIX_MINUTE_SCALE);
+    if ((degrees > 180) || (minutes >= (60 * GPSFIX_MINUTE_SCALE)))
+    {
+        return false;
+    }
+
+    /* minutes * 10^5 / 60 * 10^6 / 10^5 is minutes * 10^5 / 6 micro degrees */
+    *dst = (degrees * GPSFIX_MICRODEGREES) + (minutes / 6);
+    return true;
+}
+
+static void applyHemisphere(int32_t* coordinate, const char* text, uint8_t length, char negative)
+{
+    /* An empty hemisphere says nothing about the sign, leave the coordinate alone */
+    if (length == 0)
+    {
+        return;
+    }
+
+    /* Set the sign instead of flipping it */
+    if ((*coordinate < 0) != (text[0] == negative))
+    {
+        *coordinate = -*coordinate;
+    }
+}
+
+static void parseU8(uint8_t* dst, const char* text)
+{
+    int32_t value;
+
+    if (NmeaParser_parseFixed(text, 0, &value) && (value >= 0) && (value <= UINT8_MAX))
+    {
+        *dst = (uint8_t)value;
+    }
+}
+
+static void parseU16(uint16_t* dst, const char* text, uint8_t decimals)
+{
+    int32_t value;
+
+    if (NmeaParser_parseFixed(text, decimals, &value) && (value >= 0) && (value <= UINT16_MAX))
+    {
+        *dst = (uint16_t)value;
+    }
+}
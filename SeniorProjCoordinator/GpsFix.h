@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPSFIX_H_
+#define GPSFIX_H_
+
+#include "stdint.h"
+#include <stdbool.h>
+#include "NmeaParser.h"
+
+/* Sentences that contributed to a fix, see GpsFix.sentences */
+#define GPSFIX_SENTENCE_RMC (1 << 0)
+#define GPSFIX_SENTENCE_GGA (1 << 1)
+#define GPSFIX_SENTENCE_GSA (1 << 2)
+#define GPSFIX_SENTENCE_VTG (1 << 3)
+#define GPSFIX_SENTENCE_GSV (1 << 4)
+#define GPSFIX_SENTENCE_ALL (GPSFIX_SENTENCE_RMC | GPSFIX_SENTENCE_GGA | GPSFIX_SENTENCE_GSA | \
+                             GPSFIX_SENTENCE_VTG | GPSFIX_SENTENCE_GSV)
+
+/* Talkers that are accepted, GN is used by receivers combining several constellations */
+enum GpsFixTalker {
+    GpsFix_Talker_GPS,          /* GP */
+    GpsFix_Talker_GLONASS,      /* GL */
+    GpsFix_Talker_Combined,     /* GN */
+    GpsFix_Talker_Count,
+};
+
+/* Consolidated fix, every sentence type updates its own fields. Nothing is kept as text. */
+struct GpsFix {
+    /* RMC */
+    uint8_t valid;              /* Status 'A', the position below is current */
+    uint32_t secondsOfDay;      /* UTC */
+    uint16_t milliseconds;      /* Fraction of secondsOfDay */
+    int32_t latitude;           /* Micro degrees, south is negative */
+    int32_t longitude;          /* Micro degrees, west is negative */
+    /* GGA */
+    uint8_t quality;            /* 0 invalid, 1 GPS, 2 DGPS */
+    uint8_t satellitesUsed;
+    uint16_t hdop;              /* 1/100 */
+    int32_t altitudeDm;         /* Above mean sea level, in decimeters */
+    /* GSA */
+    uint8_t fixMode;            /* 1 no fix, 2 2D, 3 3D */
+    uint16_t pdop;              /* 1/100 */
+    uint16_t vdop;              /* 1/100 */
+    /* VTG, or RMC when VTG is not sent */
+    uint32_t speedKmh;          /* 1/100 km/h */
+    uint16_t course;            /* 1/100 degree, true north */
+    /* GSV */
+    uint8_t satellitesInView[GpsFix_Talker_Count];
+    /* GPSFIX_SENTENCE_* that contributed to the fix so far */
+    uint16_t sentences;
+    /* Valid RMC sentences so far, changes with every new position */
+    uint32_t validFixes;
+};
+
+/* Parser callbacks that route GGA, GSA, GSV, RMC and VTG sentences into the fix. Any other
+ * sentence is dropped after its address field. */
+extern const struct NmeaParserCallbacks GpsFix_parserCallbacks;
+
+/* Clears the fix */
+void GpsFix_init(void);
+
+/* Copies a consistent snapshot of the fix and returns its sequence number.
+ *
+ * The sequence number changes with every published sentence, so a reader can tell whether
+ * anything changed since its last snapshot. The parser never waits for readers, a reader that
+ * was interrupted by a publish simply copies again. Must not be called from a context with a
+ * higher priority than the parser. */
+uint32_t GpsFix_snapshot(struct GpsFix* fix);
+
+#endif /* GPSFIX_H_ */
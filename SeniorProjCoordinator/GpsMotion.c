@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "GpsMotion.h"
+
+#include <string.h>
+
+
+/***** Defines *****/
+#define GPSMOTION_MICRODEGREES          1000000
+#define GPSMOTION_METERS_PER_DEGREE     111195      /* Along a meridian, mean earth radius */
+#define GPSMOTION_HALF_TURN             (180 * GPSMOTION_MICRODEGREES)
+#define GPSMOTION_SECONDS_PER_DAY       86400
+#define GPSMOTION_COS_SHIFT             15
+
+
+/***** Prototypes *****/
+static int64_t distanceSquared(const struct GpsMotionPoint* a, const struct GpsMotionPoint* b);
+static uint32_t findFences(const struct GpsMotionPoint* point);
+static bool insideFence(const struct GpsMotionFence* fence, const struct GpsMotionPoint* point);
+static uint32_t secondsBetween(uint32_t from, uint32_t to);
+static void publish(const struct GpsMotionState* newState);
+
+
+/***** Variable declarations *****/
+/* cos(degrees) in Q15 for 0 to 90 degrees */
+static const uint16_t cosTable[91] = {
+    32767, 32762, 32747, 32722, 32687, 32642, 32587, 32523, 32448, 32364,
+    32269, 32165, 32051, 31927, 31794, 31650, 31498, 31335, 31163, 30982,
+    30791, 30591, 30381, 30162, 29934, 29697, 29451, 29196, 28932, 28659,
+    28377, 28087, 27788, 27481, 27165, 26841, 26509, 26169, 25821, 25465,
+    25101, 24730, 24351, 23964, 23571, 23170, 22762, 22347, 21925, 21497,
+    21062, 20621, 20173, 19720, 19260, 18794, 18323, 17846, 17364, 16876,
+    16384, 15886, 15383, 14876, 14364, 13848, 13328, 12803, 12275, 11743,
+    11207, 10668, 10126, 9580, 9032, 8481, 7927, 7371, 6813, 6252,
+    5690, 5126, 4560, 3993, 3425, 2856, 2286, 1715, 1144, 572,
+    0,
+};
+
+static const struct GpsMotionParams* motionParams;
+static int64_t thresholdSquared;            /* Distance threshold in micro degrees of latitude, squared */
+static uint32_t lastActiveSeconds;          /* Last fix with a published move or above the speed threshold */
+static uint32_t lastFixSeconds;
+static uint16_t lastFixMilliseconds;
+
+struct GpsMotionState gpsMotionState;       /* not static so you can see in ROV */
+static volatile uint32_t gpsMotionSequence; /* Odd while gpsMotionState is being written */
+
+
+/***** Function definitions *****/
+void GpsMotion_init(const struct GpsMotionParams* params)
+{
+    int64_t threshold;
+
+    motionParams = params;
+
+    /* Compare squared distances so no square root is needed */
+    threshold = ((int64_t)params->distanceThresholdM * GPSMOTION_MICRODEGREES) / GPSMOTION_METERS_PER_DEGREE;
+    thresholdSquared = threshold * threshold;
+
+    memset(&gpsMotionState, 0, sizeof(gpsMotionState));
+}
+
+uint8_t GpsMotion_update(const struct GpsFix* fix)
+{
+    struct GpsMotionState newState = gpsMotionState;
+    struct GpsMotionPoint point;
+    bool active = false;
+    uint8_t events = 0;
+
+    /* Every sentence publishes the fix, only look at new RMC positions */
+    if (!fix->valid || (gpsMotionState.hasPosition && (fix->secondsOfDay == lastFixSeconds) &&
+                        (fix->milliseconds == lastFixMilliseconds)))
+    {
+        return 0;
+    }
+    lastFixSeconds = fix->secondsOfDay;
+    lastFixMilliseconds = fix->milliseconds;
+
+    point.latitude = fix->latitude;
+    point.longitude = fix->longitude;
+    newState.insideFences = findFences(&point);
+
+    /* Moves are measured from the last published position, so slow drift still adds up */
+    if (!gpsMotionState.hasPosition || (newState.insideFences != gpsMotionState.insideFences) ||
+        (distanceSquared(&gpsMotionState.position, &point) >= thresholdSquared))
+    {
+        newState.position = point;
+        newState.secondsOfDay = fix->secondsOfDay;
+        newState.hasPosition = 1;
+        events |= GPSMOTION_EVENT_MOVED;
+        if (newState.insideFences != gpsMotionState.insideFences)
+        {
+            events |= GPSMOTION_EVENT_FENCE;
+        }
+        active = true;
+    }
+
+    if (fix->speedKmh >= motionParams->speedThreshold)
+    {
+        active = true;
+    }
+
+    if (active)
+    {
+        lastActiveSeconds = fix->secondsOfDay;
+        if (newState.stationary)
+        {
+            newState.stationary = 0;
+            events |= GPSMOTION_EVENT_MOVING;
+        }
+    }
+    else if (!newState.stationary &&
+             (secondsBetween(lastActiveSeconds, fix->secondsOfDay) >= motionParams->stationaryTimeoutS))
+    {
+        newState.stationary = 1;
+        events |= GPSMOTION_EVENT_STATIONARY;
+    }
+
+    if (events)
+    {
+        publish(&newState);
+    }
+
+    return events;
+}
+
+uint32_t GpsMotion_snapshot(struct GpsMotionState* state)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = gpsMotionSequence;
+        *state = *(volatile struct GpsMotionState*)&gpsMotionState;  //Volatile so the copy stays between the reads of the sequence
+    } while ((sequence & 1) || (sequence != gpsMotionSequence));
+
+    return sequence;
+}
+
+static void publish(const struct GpsMotionState* newState)
+{
+    /* The copy is volatile like the sequence, so the compiler keeps it between the increments */
+    gpsMotionSequence++;
+    *(volatile struct GpsMotionState*)&gpsMotionState = *newState;
+    gpsMotionSequence++;
+}
+
+static int64_t distanceSquared(const struct GpsMotionPoint* a, const struct GpsMotionPoint* b)
+{
+    int32_t dLatitude = b->latitude - a->latitude;
+    int32_t dLongitude = b->longitude - a->longitude;
+    int32_t degrees = ((a->latitude < 0) ? -a->latitude : a->latitude) / GPSMOTION_MICRODEGREES;
+    int64_t dx;
+
+    /* Take the short way around at the antimeridian */
+    if (dLongitude > GPSMOTION_HALF_TURN)
+    {
+        dLongitude -= 2 * GPSMOTION_HALF_TURN;
+    }
+    else if (dLongitude < -GPSMOTION_HALF_TURN)
+    {
+        dLongitude += 2 * GPSMOTION_HALF_TURN;
+    }
+
+    if (degrees > 90)
+    {
+        degrees = 90;
+    }
+
+    /* Equirectangular approximation, longitude shrinks with cos(latitude) */
+    dx = ((int64_t)dLongitude * cosTable[degrees]) >> GPSMOTION_COS_SHIFT;
+
+    return (dx * dx) + ((int64_t)dLatitude * dLatitude);
+}
+
+static uint32_t findFences(const struct GpsMotionPoint* point)
+{
+    uint32_t inside = 0;
+    uint8_t i;
+
+    for (i = 0; (i < motionParams->numFences) && (i < GPSMOTION_MAX_FENCES); i++)
+    {
+        if (insideFence(&motionParams->fences[i], point))
+        {
+            inside |= (uint32_t)1 << i;
+        }
+    }
+    return inside;
+}
+
+static bool insideFence(const struct GpsMotionFence* fence, const struct GpsMotionPoint* point)
+{
+    const struct GpsMotionPoint* a;
+    const struct GpsMotionPoint* b;
+    int64_t lhs;
+    int64_t rhs;
+    bool inside = false;
+    uint8_t i;
+    uint8_t j;
+
+    /* Ray casting towards east, the crossing test is cross multiplied to stay in integers */
+    for (i = 0, j = fence->numVertices - 1; i < fence->numVertices; j = i++)
+    {
+        a = &fence->vertices[i];
+        b = &fence->vertices[j];
+        if ((a->latitude > point->latitude) != (b->latitude > point->latitude))
+        {
+            lhs = (int64_t)(point->longitude - b->longitude) * (a->latitude - b->latitude);
+            rhs = (int64_t)(a->longitude - b->longitude) * (point->latitude - b->latitude);
+            if ((a->latitude > b->latitude) ? (lhs < rhs) : (lhs > rhs))
+            {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+static uint32_t secondsBetween(uint32_t from, uint32_t to)
+{
+    /* Seconds of day wrap at midnight */
+    return (to + GPSMOTION_SECONDS_PER_DAY - from) % GPSMOTION_SECONDS_PER_DAY;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPSMOTION_H_
+#define GPSMOTION_H_
+
+#include "stdint.h"
+#include <stdbool.h>
+#include "GpsFix.h"
+
+#define GPSMOTION_MAX_FENCES 32
+
+/* Events returned by GpsMotion_update */
+#define GPSMOTION_EVENT_MOVED       (1 << 0)    /* A new position was published */
+#define GPSMOTION_EVENT_STATIONARY  (1 << 1)    /* Entered the stationary state */
+#define GPSMOTION_EVENT_MOVING      (1 << 2)    /* Left the stationary state */
+#define GPSMOTION_EVENT_FENCE       (1 << 3)    /* Entered or left a geofence */
+
+struct GpsMotionPoint {
+    int32_t latitude;           /* Micro degrees */
+    int32_t longitude;          /* Micro degrees */
+};
+
+/* Geofence polygon, vertices in order, the last one connects back to the first */
+struct GpsMotionFence {
+    const struct GpsMotionPoint* vertices;
+    uint8_t numVertices;
+};
+
+struct GpsMotionParams {
+    uint16_t distanceThresholdM;    /* Smallest move that is published */
+    uint16_t speedThreshold;        /* 1/100 km/h, slower counts as not moving */
+    uint16_t stationaryTimeoutS;    /* Time without a published move before becoming stationary */
+    const struct GpsMotionFence* fences;    /* Optional, may be NULL */
+    uint8_t numFences;              /* At most GPSMOTION_MAX_FENCES */
+};
+
+/* Position published downstream, only updated on significant moves */
+struct GpsMotionState {
+    struct GpsMotionPoint position;
+    uint32_t secondsOfDay;      /* Time of the fix the position was taken from */
+    uint32_t insideFences;      /* Bit n is set while inside fence n */
+    uint8_t stationary;
+    uint8_t hasPosition;        /* Cleared until the first valid fix */
+};
+
+/* Initializes the filter, params must stay valid for the lifetime of the application */
+void GpsMotion_init(const struct GpsMotionParams* params);
+
+/* Runs a new fix through the filter, fixes that are not valid or were already seen are
+ * ignored. Returns the GPSMOTION_EVENT_* that occurred. Must be called from a single task. */
+uint8_t GpsMotion_update(const struct GpsFix* fix);
+
+/* Copies a consistent snapshot of the published state and returns its sequence number, see
+ * GpsFix_snapshot */
+uint32_t GpsMotion_snapshot(struct GpsMotionState* state);
+
+#endif /* GPSMOTION_H_ */
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "GpsPower.h"
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+
+/***** Defines *****/
+#define GpsPower_ms_To_Ticks(ms) ((uint32_t)(((uint64_t)(ms) * 1000) / Clock_tickPeriod))
+#define GpsPower_ticks_To_Ms(ticks) ((uint32_t)(((uint64_t)(ticks) * Clock_tickPeriod) / 1000))
+
+
+/***** Type declarations *****/
+enum GpsPowerState {
+    GpsPower_State_Acquiring,
+    GpsPower_State_Tracking,        /* Got a fix, taking the remaining fixesPerWake */
+    GpsPower_State_Standby,
+};
+
+
+/***** Prototypes *****/
+static void enterStandby(uint32_t now);
+static void recordTimeToFix(uint32_t now);
+
+
+/***** Variable declarations *****/
+static const struct GpsPowerParams* powerParams;
+static const struct GpsConfigParams* receiverParams;
+static UART_Handle receiverHandle;
+static enum GpsPowerState state;
+static uint32_t stateStartTicks;
+static uint8_t fixesLeft;
+static bool firstAcquisition;
+struct GpsPowerStats gpsPowerStats;     /* not static so you can see in ROV */
+
+
+/***** Function definitions *****/
+void GpsPower_init(const struct GpsPowerParams* params, UART_Handle handle, const struct GpsConfigParams* configParams)
+{
+    powerParams = params;
+    receiverHandle = handle;
+    receiverParams = configParams;
+
+    state = GpsPower_State_Acquiring;
+    stateStartTicks = Clock_getTicks();
+    fixesLeft = params->fixesPerWake;
+    firstAcquisition = true;
+    gpsPowerStats.minTimeToFixMs = UINT32_MAX;
+}
+
+uint32_t GpsPower_process(bool newFix)
+{
+    uint32_t now = Clock_getTicks();
+    uint32_t elapsed = now - stateStartTicks;
+    uint32_t timeout;
+
+    switch (state)
+    {
+    case GpsPower_State_Acquiring:
+        if (newFix)
+        {
+            recordTimeToFix(now);
+            state = GpsPower_State_Tracking;
+            /* Fall through to count this fix */
+        }
+        else
+        {
+            timeout = GpsPower_ms_To_Ticks((uint32_t)powerParams->acquireTimeoutS * 1000);
+            if ((powerParams->standbyIntervalS == 0) || firstAcquisition)
+            {
+                /* Keep going, the first fix after power up may take minutes */
+                return BIOS_WAIT_FOREVER;
+            }
+            if (elapsed >= timeout)
+            {
+                gpsPowerStats.timeouts++;
+                enterStandby(now);
+                return GpsPower_ms_To_Ticks(powerParams->standbyIntervalS * 1000);
+            }
+            return timeout - elapsed;
+        }
+        /* no break */
+
+    case GpsPower_State_Tracking:
+        if (newFix && (fixesLeft > 0))
+        {
+            fixesLeft--;
+        }
+        if ((powerParams->standbyIntervalS != 0) && (fixesLeft == 0))
+        {
+            enterStandby(now);
+            return GpsPower_ms_To_Ticks(powerParams->standbyIntervalS * 1000);
+        }
+        return BIOS_WAIT_FOREVER;
+
+    case GpsPower_State_Standby:
+    default:
+        timeout = GpsPower_ms_To_Ticks(powerParams->standbyIntervalS * 1000);
+        if (elapsed < timeout)
+        {
+            return timeout - elapsed;
+        }
+
+        /* Hot start, the receiver kept its ephemeris while in standby */
+        gpsPowerStats.standbyMs += GpsPower_ticks_To_Ms(elapsed);
+        gpsPowerStats.wakeups++;
+        GpsConfig_wake(receiverHandle, receiverParams);
+        state = GpsPower_State_Acquiring;
+        stateStartTicks = now;
+        fixesLeft = powerParams->fixesPerWake;
+        return GpsPower_ms_To_Ticks((uint32_t)powerParams->acquireTimeoutS * 1000);
+    }
+}
+
+bool GpsPower_isStandby(void)
+{
+    return state == GpsPower_State_Standby;
+}
+
+void GpsPower_getStats(struct GpsPowerStats* stats)
+{
+    /* Only written by the GPS task, keep readers in other tasks consistent */
+    UInt key = Hwi_disable();
+    *stats = gpsPowerStats;
+    Hwi_restore(key);
+}
+
+static void enterStandby(uint32_t now)
+{
+    GpsConfig_standby(receiverHandle, receiverParams);
+    state = GpsPower_State_Standby;
+    stateStartTicks = now;
+}
+
+static void recordTimeToFix(uint32_t now)
+{
+    uint32_t timeToFixMs = GpsPower_ticks_To_Ms(now - stateStartTicks);
+    UInt key = Hwi_disable();
+
+    if (firstAcquisition)
+    {
+        /* Not a hot start, kept apart so it does not skew the reacquisition numbers */
+        gpsPowerStats.firstTimeToFixMs = timeToFixMs;
+        firstAcquisition = false;
+        Hwi_restore(key);
+        return;
+    }
+
+    gpsPowerStats.acquisitions++;
+    gpsPowerStats.lastTimeToFixMs = timeToFixMs;
+    gpsPowerStats.totalTimeToFixMs += timeToFixMs;
+    if (timeToFixMs < gpsPowerStats.minTimeToFixMs)
+    {
+        gpsPowerStats.minTimeToFixMs = timeToFixMs;
+    }
+    if (timeToFixMs > gpsPowerStats.maxTimeToFixMs)
+    {
+        gpsPowerStats.maxTimeToFixMs = timeToFixMs;
+    }
+    Hwi_restore(key);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GPSPOWER_H_
+#define GPSPOWER_H_
+
+#include "stdint.h"
+#include <stdbool.h>
+#include <ti/drivers/UART.h>
+#include "GpsConfig.h"
+
+struct GpsPowerParams {
+    uint32_t standbyIntervalS;      /* Time in standby between fixes, 0 keeps the receiver on */
+    uint16_t acquireTimeoutS;       /* Give up on a fix after this long and go back to standby */
+    uint8_t fixesPerWake;           /* Valid fixes to take before going back to standby */
+};
+
+/* Reacquisition statistics, times are from waking the receiver to its first valid fix */
+struct GpsPowerStats {
+    uint32_t wakeups;
+    uint32_t acquisitions;          /* Wakeups that got a fix */
+    uint32_t timeouts;              /* Wakeups that did not */
+    uint32_t firstTimeToFixMs;      /* From power up, usually a cold or warm start */
+    uint32_t lastTimeToFixMs;
+    uint32_t minTimeToFixMs;
+    uint32_t maxTimeToFixMs;
+    uint32_t totalTimeToFixMs;      /* Divide by acquisitions for the average */
+    uint32_t standbyMs;             /* Time spent in standby */
+};
+
+/* Initializes duty cycling and starts timing the first acquisition.
+ *
+ * handle and configParams are the ones used to open the receiver with GpsConfig_open, all of
+ * them must stay valid for the lifetime of the application. */
+void GpsPower_init(const struct GpsPowerParams* params, UART_Handle handle, const struct GpsConfigParams* configParams);
+
+/* Runs the duty cycle, to be called by the GPS task whenever it wakes up.
+ *
+ * newFix tells whether a new valid fix arrived since the last call. Returns how many clock ticks
+ * the task may wait for UART data before calling again, or BIOS_WAIT_FOREVER. */
+uint32_t GpsPower_process(bool newFix);
+
+/* Returns true while the receiver is in standby */
+bool GpsPower_isStandby(void);
+
+/* Copies the reacquisition statistics */
+void GpsPower_getStats(struct GpsPowerStats* stats);
+
+#endif /* GPSPOWER_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "NetworkTime.h"
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "easylink/EasyLink.h"
+
+
+/***** Variable declarations *****/
+uint32_t networkTimeReferenceMs = RADIO_NETWORK_TIME_UNKNOWN;  /* not static so you can see in ROV */
+static uint64_t networkTimeReferenceTime;
+
+
+/***** Function definitions *****/
+void NetworkTime_setReference(uint32_t gpsTimeMs, uint64_t radioTime)
+{
+    UInt key = Hwi_disable();
+    networkTimeReferenceMs = gpsTimeMs % RADIO_NETWORK_TIME_MS_PER_DAY;
+    networkTimeReferenceTime = radioTime;
+    Hwi_restore(key);
+}
+
+uint32_t NetworkTime_now(void)
+{
+    uint64_t elapsedMs;
+    uint32_t now;
+    uint64_t radioTime = EasyLink_getAbsTime64();
+    UInt key = Hwi_disable();
+
+    if (networkTimeReferenceMs == RADIO_NETWORK_TIME_UNKNOWN)
+    {
+        Hwi_restore(key);
+        return RADIO_NETWORK_TIME_UNKNOWN;
+    }
+
+    /* The radio time does not wrap, so without GPS this keeps running on the local clock
+     * from the last fix however long that was ago */
+    elapsedMs = (radioTime > networkTimeReferenceTime) ?
+            EasyLink_RadioTime_To_ms(radioTime - networkTimeReferenceTime) : 0;
+    now = (uint32_t)((networkTimeReferenceMs + elapsedMs) % RADIO_NETWORK_TIME_MS_PER_DAY);
+
+    Hwi_restore(key);
+    return now;
+}
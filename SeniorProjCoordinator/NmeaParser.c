@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "NmeaParser.h"
+
+#include <string.h>
+
+
+/***** Prototypes *****/
+static void startSentence(struct NmeaParser* parser);
+static void endSentence(struct NmeaParser* parser, bool valid);
+static bool deliverField(struct NmeaParser* parser);
+static int8_t hexValue(char c);
+
+
+/***** Function definitions *****/
+void NmeaParser_init(struct NmeaParser* parser, const struct NmeaParserCallbacks* callbacks, void* arg)
+{
+    memset(parser, 0, sizeof(struct NmeaParser));
+    parser->callbacks = callbacks;
+    parser->arg = arg;
+    parser->state = NmeaParser_State_WaitStart;
+}
+
+void NmeaParser_feed(struct NmeaParser* parser, const uint8_t* data, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        NmeaParser_putChar(parser, (char)data[i]);
+    }
+}
+
+void NmeaParser_putChar(struct NmeaParser* parser, char c)
+{
+    int8_t nibble;
+
+    /* A '$' always starts a new sentence, so we resynchronize after dropped bytes */
+    if (c == '$')
+    {
+        if (parser->state != NmeaParser_State_WaitStart)
+        {
+            parser->framingErrors++;
+            endSentence(parser, false);
+        }
+        startSentence(parser);
+        return;
+    }
+
+    if (parser->state == NmeaParser_State_WaitStart)
+    {
+        return;
+    }
+
+    /* Bound the sentence, and drop it on characters that are never part of a sentence */
+    if ((++parser->sentenceLength > NMEAPARSER_MAX_SENTENCE_LENGTH) ||
+        (((c < ' ') || (c > '~')) && (c != '\r') && (c != '\n')))
+    {
+        parser->framingErrors++;
+        endSentence(parser, false);
+        return;
+    }
+
+    switch (parser->state)
+    {
+    case NmeaParser_State_Field:
+        if ((c == ',') || (c == '*'))
+        {
+            if (c == ',')
+            {
+                parser->checksum ^= c;
+            }
+            if (!deliverField(parser))
+            {
+                parser->skipped++;
+                endSentence(parser, false);
+                return;
+            }
+            if (c == '*')
+            {
+                parser->state = NmeaParser_State_ChecksumHigh;
+            }
+        }
+        else if ((c == '\r') || (c == '\n'))
+        {
+            /* Sentences without a checksum are not accepted */
+            parser->framingErrors++;
+            endSentence(parser, false);
+        }
+        else if (parser->fieldLength < NMEAPARSER_MAX_FIELD_LENGTH)
+        {
+            parser->checksum ^= c;
+            parser->field[parser->fieldLength++] = c;
+        }
+        else
+        {
+            parser->framingErrors++;
+            endSentence(parser, false);
+        }
+        break;
+
+    case NmeaParser_State_ChecksumHigh:
+    case NmeaParser_State_ChecksumLow:
+        nibble = hexValue(c);
+        if (nibble < 0)
+        {
+            parser->framingErrors++;
+            endSentence(parser, false);
+        }
+        else if (parser->state == NmeaParser_State_ChecksumHigh)
+        {
+            parser->receivedChecksum = (uint8_t)nibble << 4;
+            parser->state = NmeaParser_State_ChecksumLow;
+        }
+        else
+        {
+            parser->receivedChecksum |= (uint8_t)nibble;
+            if (parser->receivedChecksum == parser->checksum)
+            {
+                parser->sentences++;
+                endSentence(parser, true);
+            }
+            else
+            {
+                parser->checksumErrors++;
+                endSentence(parser, false);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void startSentence(struct NmeaParser* parser)
+{
+    parser->state = NmeaParser_State_Field;
+    parser->checksum = 0;
+    parser->fieldIndex = 0;
+    parser->fieldLength = 0;
+    parser->sentenceLength = 1;
+
+    if (parser->callbacks->sentenceStart)
+    {
+        parser->callbacks->sentenceStart(parser->arg);
+    }
+}
+
+static void endSentence(struct NmeaParser* parser, bool valid)
+{
+    parser->state = NmeaParser_State_WaitStart;
+    parser->callbacks->sentenceEnd(parser->arg, valid);
+}
+
+static bool deliverField(struct NmeaParser* parser)
+{
+    bool more;
+
+    parser->field[parser->fieldLength] = '\0';
+    more = parser->callbacks->field(parser->arg, parser->fieldIndex, parser->field, parser->fieldLength);
+
+    parser->fieldIndex++;
+    parser->fieldLength = 0;
+    return more;
+}
+
+static int8_t hexValue(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+bool NmeaParser_parseFixed(const char* text, uint8_t decimals, int32_t* value)
+{
+    int32_t result = 0;
+    bool negative = false;
+    bool fraction = false;
+    bool digits = false;
+    uint8_t digit;
+
+    if ((*text == '-') || (*text == '+'))
+    {
+        negative = (*text == '-');
+        text++;
+    }
+
+    for (; *text != '\0'; text++)
+    {
+        if ((*text == '.') && !fraction)
+        {
+            fraction = true;
+            continue;
+        }
+        if ((*text < '0') || (*text > '9'))
+        {
+            return false;
+        }
+        digits = true;
+        if (fraction)
+        {
+            if (decimals == 0)
+            {
+                continue;
+            }
+            decimals--;
+        }
+        digit = *text - '0';
+        if (result > ((INT32_MAX - digit) / 10))
+        {
+            return false;
+        }
+        result = (result * 10) + digit;
+    }
+
+    /* Pad missing decimals */
+    for (; decimals > 0; decimals--)
+    {
+        if (result > (INT32_MAX / 10))
+        {
+            return false;
+        }
+        result *= 10;
+    }
+
+    if (!digits)
+    {
+        return false;
+    }
+
+    *value = negative ? -result : result;
+    return true;
+}
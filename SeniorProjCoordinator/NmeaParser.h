@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NMEAPARSER_H_
+#define NMEAPARSER_H_
+
+#include "stdint.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Longest field handed to the field callback, longer fields invalidate the sentence */
+#define NMEAPARSER_MAX_FIELD_LENGTH     15
+/* NMEA 0183 limits a sentence to 82 characters including '$' and CR LF */
+#define NMEAPARSER_MAX_SENTENCE_LENGTH  82
+
+/* Callbacks of a parser, all of them run in the context calling NmeaParser_feed.
+ *
+ * Every sentenceStart is followed by exactly one sentenceEnd. Fields are delivered as soon as
+ * they are complete, before the checksum is known, so a consumer should stage them and only
+ * use them once sentenceEnd reports the sentence as valid. */
+struct NmeaParserCallbacks {
+    /* Optional, called on '$' */
+    void (*sentenceStart)(void* arg);
+    /* Called for every field, index 0 is the address field e.g. "GPRMC". The text is NUL
+     * terminated. Return false to skip the rest of the sentence, sentenceEnd then reports it
+     * as invalid. */
+    bool (*field)(void* arg, uint8_t index, const char* text, uint8_t length);
+    /* Called once the checksum was checked, or when the sentence was dropped */
+    void (*sentenceEnd)(void* arg, bool valid);
+};
+
+enum NmeaParserState {
+    NmeaParser_State_WaitStart,
+    NmeaParser_State_Field,
+    NmeaParser_State_ChecksumHigh,
+    NmeaParser_State_ChecksumLow,
+};
+
+/* Parser instance, the fields are private to the parser.
+ *
+ * The parser only holds the field being received, so its memory use does not depend on the
+ * input. Sentences may be fed in pieces of any size. The parser, GpsFix and GpsMotion only use
+ * the C library, host/ builds them with a benchmark and a fuzz harness. */
+struct NmeaParser {
+    const struct NmeaParserCallbacks* callbacks;
+    void* arg;
+    enum NmeaParserState state;
+    uint8_t checksum;
+    uint8_t receivedChecksum;
+    uint8_t fieldIndex;
+    uint8_t fieldLength;
+    uint8_t sentenceLength;
+    char field[NMEAPARSER_MAX_FIELD_LENGTH + 1];
+    /* Statistics */
+    uint32_t sentences;
+    uint32_t checksumErrors;
+    uint32_t framingErrors;
+    uint32_t skipped;
+};
+
+/* Initializes a parser, callbacks and arg must stay valid for the lifetime of the parser */
+void NmeaParser_init(struct NmeaParser* parser, const struct NmeaParserCallbacks* callbacks, void* arg);
+
+/* Feeds one received character */
+void NmeaParser_putChar(struct NmeaParser* parser, char c);
+
+/* Feeds a block of received characters */
+void NmeaParser_feed(struct NmeaParser* parser, const uint8_t* data, size_t length);
+
+/* Converts a decimal field such as "-12.345" into an integer scaled by 10^decimals, extra
+ * decimals are truncated. Returns false for empty fields, other characters and overflow. */
+bool NmeaParser_parseFixed(const char* text, uint8_t decimals, int32_t* value);
+
+#endif /* NMEAPARSER_H_ */
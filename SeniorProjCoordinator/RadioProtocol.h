@@ -43,6 +43,10 @@
 #define RADIO_PACKET_TYPE_ADC_SENSOR_PACKET      1
 #define RADIO_PACKET_TYPE_DM_SENSOR_PACKET       2
 
+/* Network time is in milliseconds of the UTC day, taken from the coordinator GPS */
+#define RADIO_NETWORK_TIME_UNKNOWN      0xFFFFFFFF
+#define RADIO_NETWORK_TIME_MS_PER_DAY   86400000
+
 struct PacketHeader {
     uint8_t sourceAddress;
     uint8_t packetType;
@@ -59,12 +63,15 @@ struct DualModeSensorPacket {
     uint16_t batt;
     uint32_t time100MiliSec;
     uint8_t button;
-    uint16_t Temp;
-    uint16_t Hum;
+    uint8_t Temp;
+    uint8_t Hum;
+    uint8_t powerPolicy;    /* Router battery policy level, 0 is normal operation */
+    uint32_t networkTimeMs; /* When the sample was taken, RADIO_NETWORK_TIME_UNKNOWN until the router is synchronized */
 };
 
 struct AckPacket {
     struct PacketHeader header;
+    uint32_t networkTimeMs; /* Coordinator network time when the ACK was sent, or RADIO_NETWORK_TIME_UNKNOWN */
 };
 
 #endif /* RADIOPROTOCOL_H_ */
@@ -51,6 +51,9 @@
 /* Board Header files */
 #include "Board.h"
 
+#include "GPS.h"
+#include "GpsDisplay.h"
+
 
 /*
  *  ======== main ========
@@ -68,6 +71,7 @@ void main(void)
     CoordinatorRFTask_init();
     CoordinatorTask_init();
     GPS_init();
+    GpsDisplay_init(GPSDISPLAY_DEFAULT_REFRESH_MS);
 
     /* Start BIOS */
     BIOS_start();
@@ -59,8 +59,10 @@
 //   - RX is enabled by calling EasyLink_receive() or EasyLink_receiveAsync().
 //   - Entering RX can be immediate or scheduled.
 //   - EasyLink_receive() is blocking and EasyLink_receiveAsync() is nonblocking.
-//   - the EasyLink API does not queue messages so calling another API function
-//     while in EasyLink_receiveAsync() will return EasyLink_Status_Busy_Error
+//   - one Async Rx can be queued next to the Async Tx operations, calling
+//     EasyLink_receiveAsync() again before its callback, or a function that
+//     reconfigures the radio while any Async operation is pending, will
+//     return EasyLink_Status_Busy_Error
 //   - an Async operation can be cancelled with EasyLink_abort()
 //   .
 // The following apply for transmit operation:
@@ -68,8 +70,9 @@
 //   - TX can be immediate or scheduled.
 //   - EasyLink_transmit() is blocking and EasyLink_transmitAsync() is nonblocking
 //   - EasyLink_transmit() for a scheduled command, or if TX can not start
-//   - the EasyLink API does not queue messages so calling another API function
-//     while in EasyLink_transmitAsync() will return EasyLink_Status_Busy_Error
+//   - up to EASYLINK_NUM_TX_CMDS Async Tx operations can be queued back to
+//     back, the RF driver runs them in order. Beyond that
+//     EasyLink_transmitAsync() returns EasyLink_Status_Busy_Error
 //   - an Async operation can be cancelled with EasyLink_abort()
 //
 // # Error handling #
@@ -102,6 +105,10 @@
 // |                               | specified modulation                              |
 // | EasyLink_transmit()           | Blocking Transmit                                 |
 // | EasyLink_transmitAsync()      | Nonblocking Transmit                              |
+// | EasyLink_transmitBuffer()     | Blocking Transmit from a caller buffer, no copy   |
+// | EasyLink_transmitBufferAsync()| Nonblocking Transmit from a caller buffer, no copy|
+// | EasyLink_transmitBufferAnd-   | Nonblocking Transmit followed by a Receive, run   |
+// | ReceiveAsync()                | by the radio core as one command chain            |
 // | EasyLink_receive()            | Blocking Receive                                  |
 // | EasyLink_receiveAsync()       | Nonblocking Receive                               |
 // | EasyLink_abort()              | Aborts a non blocking call                        |
@@ -109,6 +116,12 @@
 // | EasyLink_GetIeeeAddr()        | Gets the IEEE Address                             |
 // | EasyLink_SetFreq()            | Sets the frequency                                |
 // | EasyLink_GetFreq()            | Gets the frequency                                |
+// | EasyLink_setChannelPlan()     | Precomputes the FS commands of a set of channels  |
+// | EasyLink_setChannel()         | Switches to a channel of the channel plan         |
+// | EasyLink_setPhy()             | Switches to a cached Phy setup                    |
+// | EasyLink_enableHopping()      | Hops over the channel plan in a shared sequence   |
+// | EasyLink_scheduleHop()        | Tunes to the channel of a slot at an absolute time|
+// | EasyLink_reportChannelResult()| Feeds the ACK loss based channel blacklist        |
 // | EasyLink_SetRfPwr()           | Sets the Tx Power                                 |
 // | EasyLink_GetRfPwr()           | Gets the Tx Power                                 |
 //
@@ -156,11 +169,31 @@ extern "C"
 /// \brief defines the Max number of Rx Address filters
 #define EASYLINK_MAX_ADDR_FILTERS     3
 
-/// \brief macro to convert from Radio Time Ticks to ms
-#define EasyLink_RadioTime_To_ms(radioTime) ((1000 * radioTime) / 4000000)
+/// \brief defines the Max number of channels in a channel plan
+#define EASYLINK_MAX_CHANNELS         16
 
-/// \brief macro to convert from ms to Radio Time Ticks
-#define EasyLink_ms_To_RadioTime(ms) (ms*(4000000/1000))
+/// \brief defines the number of Async Tx operations that can be queued
+#define EASYLINK_NUM_TX_CMDS          4
+
+/// \brief defines the least number of channels channel hopping keeps out of
+/// the blacklist
+#define EASYLINK_HOP_MIN_CHANNELS     4
+
+/// \brief defines the rate of the Radio Time Ticks
+#define EASYLINK_RADIO_TIME_HZ        4000000
+
+/// \brief macro to convert from Radio Time Ticks to ms, only divides so it
+/// does not overflow for 32 or 64 bit times
+#define EasyLink_RadioTime_To_ms(radioTime) ((radioTime) / (EASYLINK_RADIO_TIME_HZ / 1000))
+
+/// \brief macro to convert from ms to Radio Time Ticks, as a 64 bit time
+#define EasyLink_ms_To_RadioTime(ms) ((uint64_t)(ms) * (EASYLINK_RADIO_TIME_HZ / 1000))
+
+/// \brief macro to convert from Radio Time Ticks to us
+#define EasyLink_RadioTime_To_us(radioTime) ((radioTime) / (EASYLINK_RADIO_TIME_HZ / 1000000))
+
+/// \brief macro to convert from us to Radio Time Ticks, as a 64 bit time
+#define EasyLink_us_To_RadioTime(us) ((uint64_t)(us) * (EASYLINK_RADIO_TIME_HZ / 1000000))
 
 /// \brief EasyLink Status and error codes
 typedef enum
@@ -192,10 +225,11 @@ typedef enum
 typedef enum
 {
     EasyLink_Ctrl_AddSize = 0, ///Set the number of bytes in Addr for both Addr
-    ///Filter and Tx/Rx operations
-    EasyLink_Ctrl_Idle_TimeOut = 1, ///Set the time for Radio to return to
-                                    ///idle after. Must be set before calling
-                                    //EasyLink_init.
+    ///Filter and Tx/Rx operations. Fails with EasyLink_Status_Config_Error
+    ///while the Addr Filter is enabled
+    EasyLink_Ctrl_Idle_TimeOut = 1, ///Set the time in us the Radio stays
+                                    ///powered after the last command. Takes
+                                    ///effect with the next Tx or Rx.
     EasyLink_Ctrl_MultiClient_Mode = 2, ///Set Multiclient mode for application
                                         ///that will use multiple RF clients.
                                         ///Must be set before calling
@@ -205,6 +239,10 @@ typedef enum
                                         ///0 means no timeout
     EasyLink_Ctrl_Test_Tone = 4, ///Enable/Disable Test mode for Tone
     EasyLink_Ctrl_Test_Signal = 5, ///Enable/Disable Test mode for Signal
+    EasyLink_Ctrl_Next_Idle_TimeOut = 6, ///Override EasyLink_Ctrl_Idle_TimeOut
+                                         ///for the next Tx or Rx only, e.g.
+                                         ///short after the last packet of an
+                                         ///exchange
 } EasyLink_CtrlOption;
 
 /// \brief Structure for the TX Packet
@@ -217,6 +255,26 @@ typedef struct
         uint8_t payload[EASYLINK_MAX_DATA_LENGTH];       ///Payload
 } EasyLink_TxPacket;
 
+/// \brief Headroom in front of the payload of an EasyLink_TxBuffer, enough
+/// for the largest address
+#define EASYLINK_TX_HEADROOM_SIZE       8
+
+/// \brief Structure for a zero copy TX Packet
+///
+/// The application builds its frame in place in payload, which is 4 byte
+/// aligned so a protocol structure can be overlaid on it. EasyLink writes the
+/// address into the headroom just in front of the payload and the RF core
+/// reads the packet directly from this buffer.
+typedef struct
+{
+        uint8_t dstAddr[8];      ///Dst Address
+        uint32_t absTime;        ///Absolute time to Tx packet (0 for immediate)
+        uint8_t len;             ///Payload Length
+        uint8_t reserved[3];
+        uint8_t headroom[EASYLINK_TX_HEADROOM_SIZE];     ///Filled by EasyLink
+        uint8_t payload[EASYLINK_MAX_DATA_LENGTH];       ///Payload
+} EasyLink_TxBuffer;
+
 /// \brief Structure for the RX'ed Packet
 typedef struct
 {
@@ -242,6 +300,42 @@ typedef void (*EasyLink_ReceiveCb)(EasyLink_RxPacket * rxPacket,
  */
 typedef void (*EasyLink_TxDoneCb)(EasyLink_Status status);
 
+/// \brief Cumulative radio statistics, kept across commands until
+/// EasyLink_resetStats is called
+typedef struct
+{
+        uint32_t nRxOk;          ///Packets received with CRC OK
+        uint32_t nRxNok;         ///Packets received with CRC error
+        uint32_t nRxIgnored;     ///Packets not matched by the RF core address filter
+        uint32_t nRxStopped;     ///Packets that started (sync found) but were not received
+        uint32_t nRxBufFull;     ///Packets lost because the Rx buffer was full
+        uint32_t nRxTimeout;     ///Receives that ended without a packet
+        uint32_t nTxOk;          ///Packets sent
+        uint32_t nTxError;       ///Transmissions that failed or were aborted
+        int8_t lastRssi;         ///RSSI of the last packet, in dBm
+        uint32_t lastTimeStamp;  ///Absolute time of the last packet
+        uint32_t nPowerUps;      ///Commands that found the Radio powered down
+        uint64_t txTimeUs;       ///Time in Tx, including a power up before it
+        uint64_t rxTimeUs;       ///Time in Rx, including a power up before it
+        uint64_t idleTimeUs;     ///Time powered between commands, until the
+                                 ///inactivity timeout powers the Radio down
+} EasyLink_Stats;
+
+/// \brief Per frame receive events, delivered when enabled with
+/// EasyLink_setRxEventCb
+typedef enum
+{
+    EasyLink_RxEvent_CrcError = 0x01, ///A packet was received with a CRC error
+    EasyLink_RxEvent_SyncOnly = 0x02, ///A sync word was found but the packet
+                                      ///was not received
+} EasyLink_RxEvent;
+
+/** \brief EasyLink Callback function type for receive events, registered
+ *  with EasyLink_setRxEventCb
+ */
+typedef void (*EasyLink_RxEventCb)(EasyLink_RxEvent event, int8_t rssi,
+        uint32_t absTime);
+
 //*****************************************************************************
 //
 //! \brief Initializes the radio with specified Phy settings
@@ -278,6 +372,37 @@ extern EasyLink_Status EasyLink_init(EasyLink_PhyType ui32ModType);
 //*****************************************************************************
 extern uint32_t EasyLink_getAbsTime(void);
 
+//*****************************************************************************
+//
+//! \brief Gets the 64 bit radio time
+//!
+//! The 32 bit radio time wraps about every 18 minutes. This time extends it:
+//! the radio time gives the resolution, and the RTC, which keeps running while
+//! the radio and the CPU sleep, tells how many times it wrapped since the
+//! last call. It never goes backwards, and its low 32 bits are the absolute
+//! time of the Tx/Rx absTime fields. Can be called from any context, also
+//! before EasyLink_init.
+//!
+//! \return absolute time in Radio Time Ticks
+//
+//*****************************************************************************
+extern uint64_t EasyLink_getAbsTime64(void);
+
+//*****************************************************************************
+//
+//! \brief Extends a 32 bit absolute time to 64 bits
+//!
+//! This function returns the 64 bit radio time closest to now with the given
+//! low 32 bits, such as the absTime of a received packet. The time must be
+//! within about 9 minutes of now.
+//!
+//! \param ui32AbsTime 32 bit absolute radio time
+//!
+//! \return absolute time in Radio Time Ticks
+//
+//*****************************************************************************
+extern uint64_t EasyLink_extendAbsTime(uint32_t ui32AbsTime);
+
 //*****************************************************************************
 //
 //! \brief Sends a Packet with blocking call.
@@ -311,6 +436,57 @@ extern EasyLink_Status EasyLink_transmit(EasyLink_TxPacket *txPacket);
 extern EasyLink_Status EasyLink_transmitAsync(EasyLink_TxPacket *txPacket,
         EasyLink_TxDoneCb cb);
 
+//*****************************************************************************
+//
+//! \brief Sends a Packet from a caller buffer with blocking call.
+//!
+//! Same as EasyLink_transmit(), but the payload is not copied. The RF core
+//! reads the packet from txBuf, which may be reused once this returns.
+//!
+//! \param txBuf - The buffer holding the packet to be Tx'ed.
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_transmitBuffer(EasyLink_TxBuffer *txBuf);
+
+//*****************************************************************************
+//
+//! \brief Sends a Packet from a caller buffer with non blocking call.
+//!
+//! Same as EasyLink_transmitAsync(), but the payload is not copied. txBuf
+//! must not be modified until the callback is called.
+//!
+//! \param txBuf - The buffer holding the packet to be Tx'ed.
+//! \param cb    - The tx done function pointer.
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_transmitBufferAsync(EasyLink_TxBuffer *txBuf,
+        EasyLink_TxDoneCb cb);
+
+//*****************************************************************************
+//
+//! \brief Sends a Packet and waits for the reply with non blocking call.
+//!
+//! The Tx is chained to an Rx on the radio core, so the Rx starts as soon as
+//! the Tx is done without waiting for the CPU. This suits waiting for an ACK.
+//! The callback is called once with the result of the Rx, or with
+//! EasyLink_Status_Tx_Error if the Tx failed. txBuf must not be modified until
+//! then.
+//!
+//! \param txBuf     - The buffer holding the packet to be Tx'ed.
+//! \param rxTimeout - Relative time in ticks from Rx start to Rx TimeOut, a
+//!                    value of 0 means no timeout.
+//! \param cb        - The rx done function pointer.
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_transmitBufferAndReceiveAsync(EasyLink_TxBuffer *txBuf,
+        uint32_t rxTimeout, EasyLink_ReceiveCb cb);
+
 //*****************************************************************************
 //
 //! \brief Blocking call that waits for an Rx Packet.
@@ -344,9 +520,9 @@ extern EasyLink_Status EasyLink_receiveAsync(EasyLink_ReceiveCb cb, uint32_t abs
 
 //*****************************************************************************
 //
-//! \brief Abort a previously call Async Tx/Rx.
+//! \brief Abort the previously called Async Tx/Rx.
 //!
-//! This function is a blocking call to abort a previous Async Tx/Rx
+//! This function is a blocking call to abort all queued Async Tx/Rx
 //!
 //! \return EasyLink_Status
 //
@@ -384,6 +560,150 @@ extern EasyLink_Status EasyLink_setFrequency(uint32_t ui16Freq);
 //*****************************************************************************
 extern uint32_t EasyLink_getFrequency(void);
 
+//*****************************************************************************
+//
+//! \brief Sets the channel plan
+//!
+//! This function precomputes a Frequency Synthesizer command for each of the
+//! frequencies, which EasyLink_setChannel then runs without any computation.
+//! The plan is kept across EasyLink_init and is recomputed for the new Phy.
+//!
+//! \param pui32Freqs Frequencies of the channels, in the units of
+//!        EasyLink_setFrequency
+//! \param ui8NumChannels Number of channels, up to EASYLINK_MAX_CHANNELS
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_setChannelPlan(const uint32_t *pui32Freqs,
+        uint8_t ui8NumChannels);
+
+//*****************************************************************************
+//
+//! \brief Sets the channel
+//!
+//! This function tunes the radio to a channel of the plan set with
+//! EasyLink_setChannelPlan.
+//!
+//! \param ui8Channel Index of the channel in the plan
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_setChannel(uint8_t ui8Channel);
+
+//*****************************************************************************
+//
+//! \brief Switches the Phy without reopening the RF driver
+//!
+//! EasyLink_init caches the setup command of every Phy the chip supports.
+//! Those that use the same RF mode (patches) as the Phy EasyLink_init was
+//! called with can be switched to by running the cached setup command. Other
+//! Phys return EasyLink_Status_Param_Error and need EasyLink_init.
+//!
+//! \param ui32ModType The Phy to switch to
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_setPhy(EasyLink_PhyType ui32ModType);
+
+//*****************************************************************************
+//
+//! \brief Enables channel hopping
+//!
+//! The channel of every slot is drawn from the channel plan by a pseudo random
+//! sequence of the seed and the slot number, so nodes that share the seed,
+//! the channel plan and the blacklist land on the same channel without
+//! exchanging any state. Slot numbering is up to the application, typically
+//! the network time divided by the dwell time.
+//!
+//! \param ui32Seed Seed of the hopping sequence, the same on all nodes
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_enableHopping(uint32_t ui32Seed);
+
+//*****************************************************************************
+//
+//! \brief Disables channel hopping
+//!
+//! The radio stays on the channel it was last tuned to.
+//
+//*****************************************************************************
+extern void EasyLink_disableHopping(void);
+
+//*****************************************************************************
+//
+//! \brief Gets the channel of a slot
+//!
+//! \param ui32Slot Slot number
+//!
+//! \return Index of the channel in the plan
+//
+//*****************************************************************************
+extern uint8_t EasyLink_getHopChannel(uint32_t ui32Slot);
+
+//*****************************************************************************
+//
+//! \brief Tunes to the channel of a slot at an absolute time
+//!
+//! Posts the cached FS command of the slot's channel with an absolute start
+//! trigger and returns without waiting, so the radio core retunes on its own
+//! and a Tx or Rx posted for the slot simply queues behind it. If another
+//! command is running at ui32AbsTime the FS runs when it ends.
+//!
+//! \param ui32Slot Slot number
+//! \param ui32AbsTime Radio time to tune at, a few hundred us before the slot
+//!
+//! \return EasyLink_Status, EasyLink_Status_Busy_Error if the previous hop is
+//! still pending
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_scheduleHop(uint32_t ui32Slot,
+        uint32_t ui32AbsTime);
+
+//*****************************************************************************
+//
+//! \brief Reports the outcome of an acknowledged transmission
+//!
+//! The ACK loss of each channel is tracked from these reports. A channel
+//! that loses most of its ACKs is blacklisted and left out of the hopping
+//! sequence, and is given another chance after a while. At least
+//! EASYLINK_HOP_MIN_CHANNELS channels stay in the sequence.
+//!
+//! \param ui8Channel Index of the channel the transmission used
+//! \param bAcked true if the ACK was received
+//
+//*****************************************************************************
+extern void EasyLink_reportChannelResult(uint8_t ui8Channel, bool bAcked);
+
+//*****************************************************************************
+//
+//! \brief Gets the channel blacklist
+//!
+//! \return Bit mask of the blacklisted channels of the plan
+//
+//*****************************************************************************
+extern uint32_t EasyLink_getChannelBlacklist(void);
+
+//*****************************************************************************
+//
+//! \brief Sets the channel blacklist
+//!
+//! Nodes hopping together must use the same blacklist. The node that reports
+//! the ACK results decides it and its peers adopt it with this function, a
+//! node that adopts a blacklist should not report results of its own.
+//!
+//! \param ui32Blacklist Bit mask of the blacklisted channels of the plan
+//!
+//! \return EasyLink_Status, EasyLink_Status_Param_Error if fewer than
+//! EASYLINK_HOP_MIN_CHANNELS channels would be left
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_setChannelBlacklist(uint32_t ui32Blacklist);
+
 //*****************************************************************************
 //
 //! \brief Enables the address filter
@@ -391,6 +711,16 @@ extern uint32_t EasyLink_getFrequency(void);
 //! This function enables the address filter to filter out address that are not
 //! in the address table provided.
 //!
+//! Up to three entries are filtered by the radio core. With more entries the
+//! radio core still matches the first three, but keeps the packets it does
+//! not match, and those are looked up in the whole table in software before
+//! the packet is copied. 1 byte addresses are held in a bitmap. Larger tables
+//! of longer addresses must be sorted in ascending order and stay valid while
+//! the filter is enabled.
+//!
+//! The address size cannot be changed with EasyLink_Ctrl_AddSize while the
+//! filter is enabled, disable it first by passing a NULL table.
+//!
 //! \param pui8AddrFilterTable A uint8 pointer to a variable size 2d array
 //!  containing the addresses to filter on.
 //! \param ui8AddrSize The size of the address elements
@@ -473,6 +803,42 @@ extern EasyLink_Status EasyLink_setCtrl(EasyLink_CtrlOption Ctrl,
 extern EasyLink_Status EasyLink_getCtrl(EasyLink_CtrlOption Ctrl,
         uint32_t* pui32Value);
 
+//*****************************************************************************
+//
+//! \brief Gets the radio statistics
+//!
+//! This function copies the statistics accumulated since EasyLink_init or the
+//! last EasyLink_resetStats. The radio times let the radio energy be split
+//! between Tx, Rx and the idle time the inactivity timeout keeps it powered.
+//!
+//! \param stats - Pointer to return the statistics
+//
+//*****************************************************************************
+extern void EasyLink_getStats(EasyLink_Stats *stats);
+
+//*****************************************************************************
+//
+//! \brief Clears the radio statistics
+//
+//*****************************************************************************
+extern void EasyLink_resetStats(void);
+
+//*****************************************************************************
+//
+//! \brief Registers a callback for per frame receive events
+//!
+//! The callback is called from the context that completes the Rx, the RF
+//! driver callback for asynchronous receives, so it must be short.
+//!
+//! \param cb - The event callback, NULL to stop the events
+//! \param ui32EventMask - The EasyLink_RxEvent values to deliver
+//!
+//! \return EasyLink_Status
+//
+//*****************************************************************************
+extern EasyLink_Status EasyLink_setRxEventCb(EasyLink_RxEventCb cb,
+        uint32_t ui32EventMask);
+
 //*****************************************************************************
 //
 // Mark the end of the C bindings section for C++ compilers.
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef EASYLINK_EASYLINKFRAG_H_
+#define EASYLINK_EASYLINKFRAG_H_
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/* Fragmentation and reassembly of messages larger than one EasyLink packet.
+ *
+ * The layer only formats and parses the part of the payload it owns, so it sits behind whatever
+ * header the application already puts in front, and the caller moves the frames with EasyLink.
+ * A message is cut into up to EASYLINKFRAG_MAX_FRAGMENTS fragments of the same size, the last one
+ * possibly shorter, each carrying:
+ *
+ *      type | messageId | index (bit 7: status requested) | count | fragmentSize | data
+ *
+ * The receiver answers a fragment that requests it with a status frame carrying the bitmap of the
+ * fragments it holds, and the sender only retransmits the ones missing from it:
+ *
+ *      type | messageId | received bitmap, little endian
+ *
+ * Sender and receiver functions must be called from a single task. */
+
+#define EASYLINKFRAG_TYPE_DATA              0xF0
+#define EASYLINKFRAG_TYPE_STATUS            0xF1
+
+#define EASYLINKFRAG_HEADER_LENGTH          5
+#define EASYLINKFRAG_STATUS_LENGTH          6
+#define EASYLINKFRAG_MAX_FRAGMENTS          32      /* Bits in the status bitmap */
+#define EASYLINKFRAG_MAX_MESSAGE_LENGTH     1024
+
+/* Messages that can be reassembled at the same time, from different sources or message ids */
+#define EASYLINKFRAG_NUM_REASSEMBLY_BUFFERS 2
+
+/* An incomplete message is dropped after this long without a new fragment */
+#define EASYLINKFRAG_REASSEMBLY_TIMEOUT_MS  5000
+
+
+typedef enum {
+    EasyLinkFrag_Status_NotFragment,    /* Not a fragment, pass the frame on */
+    EasyLinkFrag_Status_Incomplete,     /* Fragment stored, message not complete yet */
+    EasyLinkFrag_Status_Complete,       /* Message complete, release it when done */
+    EasyLinkFrag_Status_Duplicate,      /* Fragment already received */
+    EasyLinkFrag_Status_NoBuffer,       /* All reassembly buffers busy, fragment dropped */
+    EasyLinkFrag_Status_Invalid,        /* Malformed or inconsistent fragment, dropped */
+} EasyLinkFrag_Status;
+
+/* Transmit side of one message. The data must stay valid until the transfer ends. */
+struct EasyLinkFrag_Sender {
+    const uint8_t* data;
+    uint16_t length;
+    uint8_t messageId;
+    uint8_t count;
+    uint8_t fragmentSize;
+    uint8_t lastSent;           /* Index of the last fragment handed out */
+    uint32_t pending;           /* Fragments still to be sent in this burst */
+    uint32_t delivered;         /* Fragments the receiver reported */
+};
+
+/* Result of a received fragment */
+struct EasyLinkFrag_Message {
+    uint8_t source;
+    uint8_t messageId;
+    uint8_t statusRequested;    /* The sender waits for a status frame */
+    uint32_t received;          /* Fragments held by the receiver */
+    const uint8_t* data;        /* Reassembled message, only when complete */
+    uint16_t length;
+};
+
+/* Receive statistics, kept for debugging in ROV */
+struct EasyLinkFrag_Stats {
+    uint32_t messagesComplete;
+    uint32_t messagesTimedOut;
+    uint32_t fragmentsDuplicate;
+    uint32_t fragmentsNoBuffer;
+    uint32_t fragmentsInvalid;
+};
+
+
+/* Starts sending a message of length bytes with the given id, which should change from one
+ * message to the next. maxFrameLength is the room for the fragment header and data in one packet.
+ * Returns false if the message does not fit in EASYLINKFRAG_MAX_FRAGMENTS fragments. */
+bool EasyLinkFrag_startMessage(struct EasyLinkFrag_Sender* sender, const uint8_t* data,
+                               uint16_t length, uint8_t messageId, uint8_t maxFrameLength);
+
+/* Writes the next fragment of the current burst to frame. The last one of the burst requests a
+ * status from the receiver. Returns the frame length, or 0 when the burst is sent. */
+uint8_t EasyLinkFrag_nextFragment(struct EasyLinkFrag_Sender* sender, uint8_t* frame);
+
+/* Handles a status frame from the receiver, queuing the fragments it is missing as a new burst.
+ * Returns true once the receiver holds the whole message. */
+bool EasyLinkFrag_handleStatus(struct EasyLinkFrag_Sender* sender, const uint8_t* frame,
+                               uint8_t length);
+
+/* No status came back for the last burst, queues its last fragment again to request one */
+void EasyLinkFrag_statusTimeout(struct EasyLinkFrag_Sender* sender);
+
+/* Returns true once the receiver holds the whole message */
+bool EasyLinkFrag_isDelivered(const struct EasyLinkFrag_Sender* sender);
+
+/* Handles a received frame from source, an identifier of the sender such as its address.
+ * message is filled for every fragment, the data only when the status is Complete. */
+EasyLinkFrag_Status EasyLinkFrag_receive(uint8_t source, const uint8_t* frame, uint8_t length,
+                                         struct EasyLinkFrag_Message* message);
+
+/* Returns the buffer of a Complete message to the pool */
+void EasyLinkFrag_release(const struct EasyLinkFrag_Message* message);
+
+/* Writes the status frame answering message. Returns the frame length. */
+uint8_t EasyLinkFrag_buildStatus(const struct EasyLinkFrag_Message* message, uint8_t* frame);
+
+/* Copies the receive statistics */
+void EasyLinkFrag_getStats(struct EasyLinkFrag_Stats* stats);
+
+#endif /* EASYLINK_EASYLINKFRAG_H_ */
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host benchmark of the GPS input path.
+ *
+ * Every log given on the command line is fed through NmeaParser, GpsFix and GpsMotion the way
+ * the GPS task does it, in 64 byte passes with a snapshot and a motion update after each pass.
+ * The log is fed repeatedly for at least NMEABENCH_MIN_TIME_S and the rate is printed.
+ *
+ *   NmeaBench [-m minSentencesPerSecond] log.nmea...
+ *
+ * With -m the benchmark fails when a log is parsed slower than that, so it can be used as a
+ * regression gate.
+ */
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "NmeaParser.h"
+#include "GpsFix.h"
+#include "GpsMotion.h"
+
+
+/***** Defines *****/
+#define NMEABENCH_PASS_SIZE     64      /* Bytes per parser pass, bSize in GPS.c */
+#define NMEABENCH_MIN_TIME_S    1.0
+
+
+/***** Type declarations *****/
+struct NmeaBenchResult {
+    uint64_t sentences;
+    uint64_t bytes;
+    double seconds;
+    uint32_t checksumErrors;    /* Of a single run through the log */
+    uint32_t framingErrors;
+    uint32_t validFixes;
+    uint32_t moves;
+};
+
+
+/***** Variable declarations *****/
+static const struct GpsMotionParams motionParams = {
+    .distanceThresholdM = 10,   /* Same as GPS.c */
+    .speedThreshold = 300,
+    .stationaryTimeoutS = 60,
+    .fences = NULL,
+    .numFences = 0,
+};
+
+
+/***** Prototypes *****/
+static uint8_t* readLog(const char* path, size_t* length);
+static void runLog(const uint8_t* log, size_t length, struct NmeaBenchResult* result);
+static double now(void);
+
+
+/***** Function definitions *****/
+int main(int argc, char** argv)
+{
+    struct NmeaBenchResult result;
+    uint8_t* log;
+    size_t length;
+    double minRate = 0;
+    int status = EXIT_SUCCESS;
+    int first = 1;
+    int i;
+
+    if ((argc > 2) && (strcmp(argv[1], "-m") == 0))
+    {
+        minRate = strtod(argv[2], NULL);
+        first = 3;
+    }
+    if (first >= argc)
+    {
+        fprintf(stderr, "usage: %s [-m minSentencesPerSecond] log.nmea...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (i = first; i < argc; i++)
+    {
+        log = readLog(argv[i], &length);
+        if (log == NULL)
+        {
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        runLog(log, length, &result);
+        printf("%s: %.0f sentences/s, %.2f MB/s (%llu sentences in %.2f s), %u fixes, %u moves, "
+               "%u checksum and %u framing errors per run\n",
+               argv[i], result.sentences / result.seconds, result.bytes / result.seconds / 1e6,
+               (unsigned long long)result.sentences, result.seconds, result.validFixes,
+               result.moves, result.checksumErrors, result.framingErrors);
+
+        /* A log without a single fix did not exercise the path that matters */
+        if (result.validFixes == 0)
+        {
+            fprintf(stderr, "%s: no valid fix decoded\n", argv[i]);
+            status = EXIT_FAILURE;
+        }
+        if ((result.sentences / result.seconds) < minRate)
+        {
+            fprintf(stderr, "%s: below the minimum of %.0f sentences/s\n", argv[i], minRate);
+            status = EXIT_FAILURE;
+        }
+        free(log);
+    }
+
+    return status;
+}
+
+static uint8_t* readLog(const char* path, size_t* length)
+{
+    FILE* file = fopen(path, "rb");
+    uint8_t* log;
+    long size;
+
+    if (file == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    log = malloc((size > 0) ? (size_t)size : 1);
+    if ((log == NULL) || (fread(log, 1, (size_t)size, file) != (size_t)size))
+    {
+        fprintf(stderr, "%s: read failed\n", path);
+        free(log);
+        log = NULL;
+    }
+    fclose(file);
+
+    *length = (size_t)size;
+    return log;
+}
+
+static void runLog(const uint8_t* log, size_t length, struct NmeaBenchResult* result)
+{
+    struct NmeaParser parser;
+    struct GpsFix fix;
+    uint32_t sequence;
+    uint32_t lastSequence;
+    size_t offset;
+    size_t count;
+    double start;
+
+    memset(result, 0, sizeof(struct NmeaBenchResult));
+    start = now();
+
+    do
+    {
+        GpsFix_init();
+        GpsMotion_init(&motionParams);
+        NmeaParser_init(&parser, &GpsFix_parserCallbacks, NULL);
+        lastSequence = 0;
+        result->moves = 0;
+
+        for (offset = 0; offset < length; offset += count)
+        {
+            count = ((length - offset) < NMEABENCH_PASS_SIZE) ? (length - offset) : NMEABENCH_PASS_SIZE;
+            NmeaParser_feed(&parser, &log[offset], count);
+
+            sequence = GpsFix_snapshot(&fix);
+            if (sequence != lastSequence)
+            {
+                lastSequence = sequence;
+                if (GpsMotion_update(&fix) & GPSMOTION_EVENT_MOVED)
+                {
+                    result->moves++;
+                }
+            }
+        }
+
+        result->sentences += parser.sentences;
+        result->bytes += length;
+        result->seconds = now() - start;
+    } while (result->seconds < NMEABENCH_MIN_TIME_S);
+
+    result->checksumErrors = parser.checksumErrors;
+    result->framingErrors = parser.framingErrors;
+    result->validFixes = fix.validFixes;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
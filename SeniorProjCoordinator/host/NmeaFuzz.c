@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Fuzz target of the GPS input path, for libFuzzer or for the NmeaFuzzMain driver.
+ *
+ * The first byte of an input controls how the rest is fed:
+ *   bits 0-5   pass size - 1, so sentences are split at every possible position
+ *   bit 6      recompute the checksum of every sentence, so mutated sentences get past the
+ *              checksum and reach GpsFix and GpsMotion instead of being dropped
+ * The rest is the byte stream from the receiver. After every pass the fix goes through
+ * GpsMotion with a geofence, and the parser and fix invariants are checked.
+ */
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NmeaParser.h"
+#include "GpsFix.h"
+#include "GpsMotion.h"
+
+
+/***** Defines *****/
+#define NMEAFUZZ_MAX_INPUT          4096
+#define NMEAFUZZ_PASS_SIZE_MASK     0x3F
+#define NMEAFUZZ_FIX_CHECKSUMS      0x40
+
+/* parseCoordinate accepts up to 180 degrees 59.99999 minutes for both coordinates */
+#define NMEAFUZZ_MAX_MICRODEGREES   181000000
+
+#define nmeaFuzzCheck(condition) \
+    do { if (!(condition)) { fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition); abort(); } } while (0)
+
+
+/***** Variable declarations *****/
+static const struct GpsMotionPoint fenceVertices[] = {
+    { 47600000, -122340000 },
+    { 47600000, -122320000 },
+    { 47620000, -122320000 },
+    { 47620000, -122340000 },
+};
+
+static const struct GpsMotionFence fences[] = {
+    { fenceVertices, sizeof(fenceVertices) / sizeof(fenceVertices[0]) },
+};
+
+static const struct GpsMotionParams motionParams = {
+    .distanceThresholdM = 10,
+    .speedThreshold = 300,
+    .stationaryTimeoutS = 60,
+    .fences = fences,
+    .numFences = 1,
+};
+
+static uint8_t stream[NMEAFUZZ_MAX_INPUT];
+
+
+/***** Prototypes *****/
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+static void fixChecksums(uint8_t* data, size_t size);
+static void checkInvariants(const struct NmeaParser* parser, const struct GpsFix* fix,
+                            const struct GpsMotionState* motion);
+
+
+/***** Function definitions *****/
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    struct NmeaParser parser;
+    struct GpsFix fix;
+    struct GpsMotionState motion;
+    size_t passSize;
+    size_t offset;
+    size_t count;
+
+    if ((size < 1) || (size > NMEAFUZZ_MAX_INPUT))
+    {
+        return 0;
+    }
+    passSize = (data[0] & NMEAFUZZ_PASS_SIZE_MASK) + 1;
+    size--;
+    memcpy(stream, &data[1], size);
+    if (data[0] & NMEAFUZZ_FIX_CHECKSUMS)
+    {
+        fixChecksums(stream, size);
+    }
+
+    GpsFix_init();
+    GpsMotion_init(&motionParams);
+    NmeaParser_init(&parser, &GpsFix_parserCallbacks, NULL);
+
+    for (offset = 0; offset < size; offset += count)
+    {
+        count = ((size - offset) < passSize) ? (size - offset) : passSize;
+        NmeaParser_feed(&parser, &stream[offset], count);
+
+        GpsFix_snapshot(&fix);
+        GpsMotion_update(&fix);
+        GpsMotion_snapshot(&motion);
+        checkInvariants(&parser, &fix, &motion);
+    }
+
+    return 0;
+}
+
+/* Writes the checksum over every "$...*" into the two characters after the '*' */
+static void fixChecksums(uint8_t* data, size_t size)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint8_t checksum = 0;
+    bool inSentence = false;
+    size_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        if (data[i] == '$')
+        {
+            inSentence = true;
+            checksum = 0;
+        }
+        else if (inSentence && (data[i] == '*'))
+        {
+            if ((i + 2) < size)
+            {
+                data[i + 1] = hex[checksum >> 4];
+                data[i + 2] = hex[checksum & 0x0F];
+            }
+            inSentence = false;
+        }
+        else if (inSentence)
+        {
+            checksum ^= data[i];
+        }
+    }
+}
+
+static void checkInvariants(const struct NmeaParser* parser, const struct GpsFix* fix,
+                            const struct GpsMotionState* motion)
+{
+    nmeaFuzzCheck(parser->fieldLength <= NMEAPARSER_MAX_FIELD_LENGTH);
+    nmeaFuzzCheck((parser->state == NmeaParser_State_WaitStart) ||
+                  (parser->sentenceLength <= NMEAPARSER_MAX_SENTENCE_LENGTH));
+
+    nmeaFuzzCheck(fix->secondsOfDay <= 86400);
+    nmeaFuzzCheck(fix->milliseconds < 1000);
+    nmeaFuzzCheck((fix->latitude >= -NMEAFUZZ_MAX_MICRODEGREES) && (fix->latitude <= NMEAFUZZ_MAX_MICRODEGREES));
+    nmeaFuzzCheck((fix->longitude >= -NMEAFUZZ_MAX_MICRODEGREES) && (fix->longitude <= NMEAFUZZ_MAX_MICRODEGREES));
+    nmeaFuzzCheck((fix->sentences & ~GPSFIX_SENTENCE_ALL) == 0);
+
+    nmeaFuzzCheck(motion->hasPosition || (motion->insideFences == 0));
+    nmeaFuzzCheck((motion->insideFences >> motionParams.numFences) == 0);
+}
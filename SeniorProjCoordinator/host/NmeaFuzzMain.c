@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Standalone driver of the NmeaFuzz target, for hosts without libFuzzer.
+ *
+ * Runs every input of the corpus once, then the given number of inputs mutated from it with
+ * bit flips, NMEA punctuation, insertions, deletions and splices. Meant to be built with
+ * AddressSanitizer and UndefinedBehaviorSanitizer, which abort on the first finding.
+ *
+ *   NmeaFuzzMain [-r runs] [-s seed] corpus_dir_or_file...
+ */
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "stdint.h"
+
+
+/***** Defines *****/
+#define NMEAFUZZMAIN_MAX_INPUTS     256
+#define NMEAFUZZMAIN_MAX_SIZE       1024
+#define NMEAFUZZMAIN_MAX_MUTATIONS  8
+
+
+/***** Type declarations *****/
+struct NmeaFuzzInput {
+    uint8_t* data;
+    size_t size;
+};
+
+
+/***** Variable declarations *****/
+static struct NmeaFuzzInput inputs[NMEAFUZZMAIN_MAX_INPUTS];
+static size_t numInputs;
+static uint8_t mutated[NMEAFUZZMAIN_MAX_SIZE];
+
+/* Characters that move the parser between states */
+static const char punctuation[] = "$,*\r\n.-0123456789ABCDEFNSEWAV";
+
+
+/***** Prototypes *****/
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+static void loadPath(const char* path);
+static void loadFile(const char* path);
+static size_t mutate(size_t size);
+
+
+/***** Function definitions *****/
+int main(int argc, char** argv)
+{
+    unsigned long runs = 100000;
+    unsigned long run;
+    unsigned int seed = 1;
+    const struct NmeaFuzzInput* input;
+    size_t size;
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((strcmp(argv[arg], "-r") == 0) && ((arg + 1) < argc))
+        {
+            runs = strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((strcmp(argv[arg], "-s") == 0) && ((arg + 1) < argc))
+        {
+            seed = (unsigned int)strtoul(argv[++arg], NULL, 0);
+        }
+        else
+        {
+            loadPath(argv[arg]);
+        }
+    }
+
+    if (numInputs == 0)
+    {
+        fprintf(stderr, "usage: %s [-r runs] [-s seed] corpus_dir_or_file...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < numInputs; i++)
+    {
+        LLVMFuzzerTestOneInput(inputs[i].data, inputs[i].size);
+    }
+
+    srand(seed);
+    for (run = 0; run < runs; run++)
+    {
+        input = &inputs[(size_t)rand() % numInputs];
+        size = (input->size < NMEAFUZZMAIN_MAX_SIZE) ? input->size : NMEAFUZZMAIN_MAX_SIZE;
+        memcpy(mutated, input->data, size);
+        size = mutate(size);
+        LLVMFuzzerTestOneInput(mutated, size);
+    }
+
+    printf("%lu corpus inputs and %lu mutated inputs, seed %u, no findings\n",
+           (unsigned long)numInputs, runs, seed);
+    return EXIT_SUCCESS;
+}
+
+static void loadPath(const char* path)
+{
+    struct stat info;
+    struct dirent* entry;
+    DIR* dir;
+    char file[1024];
+
+    if (stat(path, &info) != 0)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if (!S_ISDIR(info.st_mode))
+    {
+        loadFile(path);
+        return;
+    }
+
+    dir = opendir(path);
+    while ((dir != NULL) && ((entry = readdir(dir)) != NULL))
+    {
+        if (entry->d_name[0] != '.')
+        {
+            snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+            loadFile(file);
+        }
+    }
+    if (dir != NULL)
+    {
+        closedir(dir);
+    }
+}
+
+static void loadFile(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    struct NmeaFuzzInput* input = &inputs[numInputs];
+
+    if ((file == NULL) || (numInputs >= NMEAFUZZMAIN_MAX_INPUTS))
+    {
+        fprintf(stderr, "%s: not loaded\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    input->data = malloc(NMEAFUZZMAIN_MAX_SIZE);
+    input->size = fread(input->data, 1, NMEAFUZZMAIN_MAX_SIZE, file);
+    fclose(file);
+    if (input->size > 0)
+    {
+        numInputs++;
+    }
+}
+
+static size_t mutate(size_t size)
+{
+    const struct NmeaFuzzInput* other;
+    size_t mutations = 1 + ((size_t)rand() % NMEAFUZZMAIN_MAX_MUTATIONS);
+    size_t position;
+    size_t length;
+
+    while (mutations-- > 0)
+    {
+        position = (size > 0) ? ((size_t)rand() % size) : 0;
+
+        switch (rand() % 6)
+        {
+        case 0:     /* Flip a bit, the control byte included */
+            if (size > 0)
+            {
+                mutated[position] ^= (uint8_t)(1 << (rand() % 8));
+            }
+            break;
+        case 1:     /* Overwrite with punctuation */
+            if (size > 0)
+            {
+                mutated[position] = (uint8_t)punctuation[(size_t)rand() % (sizeof(punctuation) - 1)];
+            }
+            break;
+        case 2:     /* Insert a random byte */
+            if (size < NMEAFUZZMAIN_MAX_SIZE)
+            {
+                memmove(&mutated[position + 1], &mutated[position], size - position);
+                mutated[position] = (uint8_t)rand();
+                size++;
+            }
+            break;
+        case 3:     /* Delete a run of bytes */
+            if (size > 0)
+            {
+                length = 1 + ((size_t)rand() % (size - position));
+                memmove(&mutated[position], &mutated[position + length], size - position - length);
+                size -= length;
+            }
+            break;
+        case 4:     /* Repeat a run of bytes, e.g. a field or a whole sentence */
+            length = (size > position) ? (1 + ((size_t)rand() % (size - position))) : 0;
+            if ((length > 0) && ((size + length) <= NMEAFUZZMAIN_MAX_SIZE))
+            {
+                memmove(&mutated[position + length], &mutated[position], size - position);
+                size += length;
+            }
+            break;
+        default:    /* Splice in the tail of another input */
+            other = &inputs[(size_t)rand() % numInputs];
+            length = (other->size > 1) ? ((size_t)rand() % other->size) : 0;
+            if ((position + (other->size - length)) <= NMEAFUZZMAIN_MAX_SIZE)
+            {
+                memcpy(&mutated[position], &other->data[length], other->size - length);
+                size = position + (other->size - length);
+            }
+            break;
+        }
+    }
+
+    return size;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "BatteryPolicy.h"
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+#include <driverlib/aon_batmon.h>
+
+#include "NodeScheduler.h"
+#include "NodeTask.h"
+#include "NodeRFTask.h"
+#include "TempHum.h"
+
+
+/***** Defines *****/
+/* Filtered value is kept with 3 extra fractional bits, the filter weight is 1/8 */
+#define BATTERYPOLICY_FILTER_SHIFT 3
+
+
+/***** Variable declarations *****/
+static const struct BatteryPolicyParams* policies;
+static uint16_t hysteresis;
+static enum BatteryPolicyLevel level = BatteryPolicy_Level_Normal;
+static uint16_t latestBatt;
+static uint32_t filteredBattScaled;
+static int16_t trend;
+static struct NodeSchedulerJob batteryJob;
+
+
+/***** Prototypes *****/
+static void sampleBattery(void);
+static enum BatteryPolicyLevel selectLevel(uint16_t batt);
+static void applyPolicy(void);
+
+
+/***** Function definitions *****/
+void BatteryPolicy_init(const struct BatteryPolicyParams* policyTable, uint16_t hysteresisBatt)
+{
+    uint8_t i;
+
+    for (i = 0; i < BatteryPolicy_Level_Count; i++)
+    {
+        if (policyTable[i].schedulerPeriodMs == 0)
+        {
+            System_abort("BatteryPolicy: schedulerPeriodMs must not be 0");
+        }
+    }
+
+    policies = policyTable;
+    hysteresis = hysteresisBatt;
+    level = BatteryPolicy_Level_Normal;
+    filteredBattScaled = 0;
+
+    /* Read the battery in the same wake window as the other sensors */
+    NodeScheduler_addPeriodicJob(&batteryJob, sampleBattery, NodeScheduler_Stage_Sample, 1);
+}
+
+uint16_t BatteryPolicy_getBattery(void)
+{
+    return latestBatt;
+}
+
+uint16_t BatteryPolicy_getFilteredBattery(void)
+{
+    return (uint16_t)(filteredBattScaled >> BATTERYPOLICY_FILTER_SHIFT);
+}
+
+int16_t BatteryPolicy_getTrend(void)
+{
+    return trend;
+}
+
+enum BatteryPolicyLevel BatteryPolicy_getLevel(void)
+{
+    return level;
+}
+
+static void sampleBattery(void)
+{
+    uint16_t previousFiltered = BatteryPolicy_getFilteredBattery();
+    enum BatteryPolicyLevel newLevel;
+
+    latestBatt = (uint16_t)AONBatMonBatteryVoltageGet();
+
+    if (filteredBattScaled == 0)
+    {
+        /* First sample, start the filter at the measured value */
+        filteredBattScaled = (uint32_t)latestBatt << BATTERYPOLICY_FILTER_SHIFT;
+        previousFiltered = latestBatt;
+    }
+    else
+    {
+        /* filtered += (sample - filtered) / 8, so a single dip under load does not switch policy */
+        filteredBattScaled = filteredBattScaled - (filteredBattScaled >> BATTERYPOLICY_FILTER_SHIFT) + latestBatt;
+    }
+    trend = (int16_t)BatteryPolicy_getFilteredBattery() - (int16_t)previousFiltered;
+
+    newLevel = selectLevel(BatteryPolicy_getFilteredBattery());
+    if (newLevel != level)
+    {
+        level = newLevel;
+        applyPolicy();
+    }
+}
+
+static enum BatteryPolicyLevel selectLevel(uint16_t batt)
+{
+    enum BatteryPolicyLevel newLevel = level;
+
+    /* Step down as long as we are below the threshold of the next level */
+    while ((newLevel + 1 < BatteryPolicy_Level_Count) &&
+           (batt < policies[newLevel + 1].enterBelowBatt))
+    {
+        newLevel++;
+    }
+
+    /* Step up only once the voltage recovered past the hysteresis */
+    while ((newLevel > BatteryPolicy_Level_Normal) &&
+           (batt >= policies[newLevel].enterBelowBatt + hysteresis))
+    {
+        newLevel--;
+    }
+
+    return newLevel;
+}
+
+static void applyPolicy(void)
+{
+    const struct BatteryPolicyParams* params = &policies[level];
+
+    NodeScheduler_setPeriod(params->schedulerPeriodMs);
+    NodeTask_setAdcReportConfig(params->adcFastReportInterval, params->adcChangeMask);
+    TempHum_setSampleInterval(params->tempHumPeriodWindows);
+    NodeRadioTask_setMaxRetries(params->maxRetries);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BATTERYPOLICY_H_
+#define BATTERYPOLICY_H_
+
+#include "stdint.h"
+
+/* Power policy levels, also sent to the coordinator in the DualModeSensorPacket */
+enum BatteryPolicyLevel {
+    BatteryPolicy_Level_Normal,
+    BatteryPolicy_Level_Conserve,
+    BatteryPolicy_Level_Critical,
+    BatteryPolicy_Level_Count,
+};
+
+/* Settings applied while a policy level is active */
+struct BatteryPolicyParams {
+    uint16_t enterBelowBatt;        /* Filtered battery voltage (1/256 V) below which the level is entered */
+    uint32_t schedulerPeriodMs;     /* NodeScheduler wake window period, paces the periodic reports, not 0 */
+    uint16_t adcFastReportInterval; /* SCE fast report interval, in units of samplingTime */
+    uint16_t adcChangeMask;         /* SCE ADC change mask */
+    uint16_t tempHumPeriodWindows;  /* HTU21D sampled every n'th scheduler wake window */
+    uint8_t maxRetries;             /* Radio retry budget per packet */
+};
+
+/* Initializes the battery policy and registers the battery sampling job with the NodeScheduler.
+ *
+ * policyTable must hold BatteryPolicy_Level_Count entries ordered from Normal to Critical and
+ * stay valid for the lifetime of the application. The enterBelowBatt of the Normal level is not
+ * used. A level is left again once the filtered voltage rises hysteresisBatt above its threshold.
+ */
+void BatteryPolicy_init(const struct BatteryPolicyParams* policyTable, uint16_t hysteresisBatt);
+
+/* Returns the latest raw battery voltage in 1/256 V */
+uint16_t BatteryPolicy_getBattery(void);
+
+/* Returns the filtered battery voltage in 1/256 V */
+uint16_t BatteryPolicy_getFilteredBattery(void);
+
+/* Returns the change of the filtered battery voltage over the last sample, in 1/256 V */
+int16_t BatteryPolicy_getTrend(void);
+
+/* Returns the active policy level */
+enum BatteryPolicyLevel BatteryPolicy_getLevel(void);
+
+#endif /* BATTERYPOLICY_H_ */
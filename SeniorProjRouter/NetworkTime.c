@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "NetworkTime.h"
+
+#include <xdc/std.h>
+
+#include "easylink/EasyLink.h"
+
+
+/***** Defines *****/
+/* From the coordinator reading its clock to the sync word of the ACK, which is what the
+ * Rx timestamp marks: Tx setup and the preamble */
+#define NETWORKTIME_ACK_LATENCY_MS      1
+
+/* Drift is only measured over intervals long enough for the millisecond resolution not to matter,
+ * and short enough for a lost ACK stream not to be mistaken for drift */
+#define NETWORKTIME_MIN_DRIFT_INTERVAL_MS   (60000)
+#define NETWORKTIME_MAX_DRIFT_INTERVAL_MS   (3600000)
+
+/* Larger errors are a step of the coordinator time, not drift */
+#define NETWORKTIME_MAX_DRIFT_ERROR_MS      (1000)
+#define NETWORKTIME_MAX_DRIFT_PPM           (500)
+#define NETWORKTIME_DRIFT_FILTER_SHIFT      2   /* Each measurement moves the estimate by 1/4 */
+
+
+/***** Variable declarations *****/
+struct NetworkTimeState networkTimeState = {    /* not static so you can see in ROV */
+    .referenceMs = RADIO_NETWORK_TIME_UNKNOWN,
+    .anchorMs = RADIO_NETWORK_TIME_UNKNOWN,
+};
+
+
+/***** Prototypes *****/
+static int64_t compensate(uint64_t localMs);
+static uint32_t predict(uint64_t radioTime);
+static int32_t difference(uint32_t a, uint32_t b);
+
+
+/***** Function definitions *****/
+void NetworkTime_synchronize(uint32_t networkTimeMs, uint64_t rxTime)
+{
+    uint64_t intervalMs;
+    int32_t measuredPpm;
+
+    networkTimeMs = (networkTimeMs + NETWORKTIME_ACK_LATENCY_MS) % RADIO_NETWORK_TIME_MS_PER_DAY;
+
+    if (networkTimeState.referenceMs != RADIO_NETWORK_TIME_UNKNOWN)
+    {
+        networkTimeState.lastErrorMs = difference(predict(rxTime), networkTimeMs);
+    }
+
+    if (networkTimeState.anchorMs != RADIO_NETWORK_TIME_UNKNOWN)
+    {
+        intervalMs = EasyLink_RadioTime_To_ms(rxTime - networkTimeState.anchorTime);
+        if ((intervalMs > NETWORKTIME_MAX_DRIFT_INTERVAL_MS) ||
+            (networkTimeState.lastErrorMs > NETWORKTIME_MAX_DRIFT_ERROR_MS) ||
+            (networkTimeState.lastErrorMs < -NETWORKTIME_MAX_DRIFT_ERROR_MS))
+        {
+            /* Stepped or out of touch for too long, start measuring again from here */
+            networkTimeState.anchorMs = RADIO_NETWORK_TIME_UNKNOWN;
+        }
+        else if (intervalMs >= NETWORKTIME_MIN_DRIFT_INTERVAL_MS)
+        {
+            /* Network time elapsed against uncompensated local time over the interval */
+            measuredPpm = (int32_t)(((int64_t)(difference(networkTimeMs, networkTimeState.anchorMs) - (int32_t)intervalMs) * 1000000) / (int32_t)intervalMs);
+            if (measuredPpm > NETWORKTIME_MAX_DRIFT_PPM)
+            {
+                measuredPpm = NETWORKTIME_MAX_DRIFT_PPM;
+            }
+            else if (measuredPpm < -NETWORKTIME_MAX_DRIFT_PPM)
+            {
+                measuredPpm = -NETWORKTIME_MAX_DRIFT_PPM;
+            }
+            networkTimeState.driftPpm += (measuredPpm - networkTimeState.driftPpm) / (1 << NETWORKTIME_DRIFT_FILTER_SHIFT);
+            networkTimeState.anchorMs = RADIO_NETWORK_TIME_UNKNOWN;
+        }
+    }
+
+    if (networkTimeState.anchorMs == RADIO_NETWORK_TIME_UNKNOWN)
+    {
+        networkTimeState.anchorMs = networkTimeMs;
+        networkTimeState.anchorTime = rxTime;
+    }
+
+    networkTimeState.referenceMs = networkTimeMs;
+    networkTimeState.referenceTime = rxTime;
+    networkTimeState.syncs++;
+}
+
+uint32_t NetworkTime_now(void)
+{
+    if (networkTimeState.referenceMs == RADIO_NETWORK_TIME_UNKNOWN)
+    {
+        return RADIO_NETWORK_TIME_UNKNOWN;
+    }
+
+    /* The radio time does not wrap, so without ACKs this keeps running on the compensated
+     * local clock from the last reference */
+    return predict(EasyLink_getAbsTime64());
+}
+
+/* Corrects a local time interval for the estimated drift */
+static int64_t compensate(uint64_t localMs)
+{
+    return (int64_t)localMs + (((int64_t)localMs * networkTimeState.driftPpm) / 1000000);
+}
+
+/* Network time at the given radio time, extrapolated from the reference */
+static uint32_t predict(uint64_t radioTime)
+{
+    int64_t elapsedMs = compensate(EasyLink_RadioTime_To_ms(radioTime - networkTimeState.referenceTime));
+    return (uint32_t)((networkTimeState.referenceMs + elapsedMs) % RADIO_NETWORK_TIME_MS_PER_DAY);
+}
+
+/* a - b in milliseconds, across midnight */
+static int32_t difference(uint32_t a, uint32_t b)
+{
+    int32_t diff = (int32_t)a - (int32_t)b;
+
+    if (diff > (RADIO_NETWORK_TIME_MS_PER_DAY / 2))
+    {
+        diff -= RADIO_NETWORK_TIME_MS_PER_DAY;
+    }
+    else if (diff < -(RADIO_NETWORK_TIME_MS_PER_DAY / 2))
+    {
+        diff += RADIO_NETWORK_TIME_MS_PER_DAY;
+    }
+    return diff;
+}
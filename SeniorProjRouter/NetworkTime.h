@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NETWORKTIME_H_
+#define NETWORKTIME_H_
+
+#include "stdint.h"
+#include "RadioProtocol.h"
+
+/* Synchronization state, kept for debugging in ROV */
+struct NetworkTimeState {
+    uint32_t referenceMs;       /* Network time at referenceTime, RADIO_NETWORK_TIME_UNKNOWN until the first ACK */
+    uint64_t referenceTime;     /* EasyLink 64-bit radio time */
+    uint32_t anchorMs;          /* Start of the current drift measurement */
+    uint64_t anchorTime;
+    int32_t driftPpm;           /* Local clock correction, positive when the local clock runs slow */
+    int32_t lastErrorMs;        /* Predicted minus received network time at the last synchronization */
+    uint32_t syncs;
+};
+
+/* Synchronizes to the network time carried by an ACK.
+ *
+ * networkTimeMs is the time the coordinator put in the ACK and rxTime the EasyLink 64-bit radio
+ * time of its sync word, see EasyLink_extendAbsTime(). Successive synchronizations estimate the local clock drift, which is
+ * compensated for until the next one. Must be called from the radio task. */
+void NetworkTime_synchronize(uint32_t networkTimeMs, uint64_t rxTime);
+
+/* Returns the network time in milliseconds of the UTC day, or RADIO_NETWORK_TIME_UNKNOWN
+ * before the first synchronization. Must be called from the radio task. */
+uint32_t NetworkTime_now(void);
+
+#endif /* NETWORKTIME_H_ */
@@ -38,7 +38,6 @@
 #include <ti/sysbios/knl/Task.h>
 #include <ti/sysbios/knl/Semaphore.h>
 #include <ti/sysbios/knl/Event.h>
-#include <ti/sysbios/knl/Clock.h>
 #include <ti/drivers/Power.h>
 #include <ti/drivers/power/PowerCC26XX.h>
 
@@ -50,12 +49,16 @@
 #include "Board.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <driverlib/trng.h>
 #include <driverlib/aon_batmon.h>
 #include "easylink/EasyLink.h"
 #include "RadioProtocol.h"
 #include "NodeRFTask.h"
 #include "TempHum.h"
+#include "ReportFilter.h"
+#include "BatteryPolicy.h"
+#include "NetworkTime.h"
 
 /***** Defines *****/
 #define NODERADIO_TASK_STACK_SIZE 1024
@@ -70,10 +73,27 @@
 #define NODERADIO_MAX_RETRIES 2
 #define NORERADIO_ACK_TIMEOUT_TIME_MS (160)
 
+/* Nothing follows the ACK, so the radio powers down soon after an exchange. A retry is
+ * posted by the task right after the ACK timeout, well within this. */
+#define NODERADIO_EXCHANGE_IDLE_TIMEOUT_US  (500)
+
+/* Maximum time without a report, even if no channel changed (10 min) */
+#define NODERADIO_REPORT_HEARTBEAT_MS   (600000)
+
+/* Report-on-change thresholds, in the units sent in the DualModeSensorPacket */
+#define NODERADIO_ADC_DEADBAND          16  /* Same resolution as NODE_ADCTASK_CHANGE_MASK */
+#define NODERADIO_ADC_HYSTERESIS        8
+#define NODERADIO_BATT_DEADBAND         13  /* ~50mV, battery is in 1/256 V */
+#define NODERADIO_BATT_HYSTERESIS       6
+#define NODERADIO_TEMP_DEADBAND         1   /* 1 deg F */
+#define NODERADIO_TEMP_HYSTERESIS       1
+#define NODERADIO_HUM_DEADBAND          2   /* 2 %RH */
+#define NODERADIO_HUM_HYSTERESIS        1
+
 
 /***** Type declarations *****/
 struct RadioOperation {
-    EasyLink_TxPacket easyLinkTxPacket;
+    EasyLink_TxBuffer easyLinkTxBuffer;
     uint8_t retriesDone;
     uint8_t maxNumberOfRetries;
     uint32_t ackTimeoutMs;
@@ -93,13 +113,19 @@ Semaphore_Struct radioResultSem;  /* not static so you can see in ROV */
 static Semaphore_Handle radioResultSemHandle;
 static struct RadioOperation currentRadioOperation;
 static uint16_t adcData;
+static uint8_t maxRetries = NODERADIO_MAX_RETRIES;
 static uint8_t nodeAddress = 0;
-static struct DualModeSensorPacket dmSensorPacket;
+/* Built in place in the TX buffer, the RF core sends it from there */
+static struct DualModeSensorPacket* const dmSensorPacket = (struct DualModeSensorPacket*)currentRadioOperation.easyLinkTxBuffer.payload;
 struct point test;
 
 
-/* previous Tick count used to calculate uptime for the Sub1G packet */
-static uint32_t prevTicks;
+/* Radio time the task started at, the uptime in the Sub1G packet counts from here */
+static uint64_t startTime;
+
+/* Network time from the latest ACK and the radio time its sync word was received at */
+static uint32_t ackNetworkTimeMs = RADIO_NETWORK_TIME_UNKNOWN;
+static uint64_t ackRxTime;
 
 /* Pin driver handle */
 extern PIN_Handle ledPinHandle;
@@ -107,9 +133,10 @@ extern PIN_Handle ledPinHandle;
 /***** Prototypes *****/
 static void nodeRadioTaskFunction(UArg arg0, UArg arg1);
 static void returnRadioOperationStatus(enum NodeRadioOperationStatus status);
-static void sendDmPacket(struct DualModeSensorPacket sensorPacket, uint8_t maxNumberOfRetries, uint32_t ackTimeoutMs);
+static void sendDmPacket(uint8_t maxNumberOfRetries, uint32_t ackTimeoutMs);
 static void resendPacket();
 static void rxDoneCallback(EasyLink_RxPacket * rxPacket, EasyLink_Status status);
+static void initReportFilter(void);
 
 /***** Function definitions *****/
 void NodeRadioTask_init(void) {
@@ -175,52 +202,65 @@ static void nodeRadioTaskFunction(UArg arg0, UArg arg1)
     }
 
     /* Setup ADC sensor packet */
-    dmSensorPacket.header.sourceAddress = nodeAddress;
-    dmSensorPacket.header.packetType = RADIO_PACKET_TYPE_DM_SENSOR_PACKET;
+    dmSensorPacket->header.sourceAddress = nodeAddress;
+    dmSensorPacket->header.packetType = RADIO_PACKET_TYPE_DM_SENSOR_PACKET;
 
+    /* Only key the radio when a channel changed or the heartbeat expired */
+    initReportFilter();
 
-    /* Initialise previous Tick count used to calculate uptime for the TLM beacon */
-    prevTicks = Clock_getTicks();
+    /* Uptime is taken from the non-wrapping radio time, so nothing is lost between readings */
+    startTime = EasyLink_getAbsTime64();
 
     /* Enter main task loop */
     while (1)
     {
-        Task_sleep(10000000/ Clock_tickPeriod);
         /* Wait for an event */
         uint32_t events = Event_pend(radioOperationEventHandle, 0, RADIO_EVENT_ALL, BIOS_WAIT_FOREVER);
 
         /* If we should send ADC data */
         if (events & RADIO_EVENT_SEND_ADC_DATA)
         {
-            uint32_t currentTicks;
-
-            currentTicks = Clock_getTicks();
-            //check for wrap around
-            if (currentTicks > prevTicks)
+            //uptime in 0.1s units
+            dmSensorPacket->time100MiliSec = (uint32_t)(EasyLink_RadioTime_To_ms(EasyLink_getAbsTime64() - startTime) / 100);
+
+            dmSensorPacket->batt = BatteryPolicy_getBattery();
+            dmSensorPacket->powerPolicy = (uint8_t)BatteryPolicy_getLevel();
+            dmSensorPacket->adcValue = adcData;
+            dmSensorPacket->button = !PIN_getInputValue(Board_BUTTON0);
+            dmSensorPacket->Temp = *test.t;
+            dmSensorPacket->Hum = *test.h;
+            dmSensorPacket->networkTimeMs = NetworkTime_now();
+
+            ReportFilter_update(ReportFilter_Channel_Adc, dmSensorPacket->adcValue);
+            ReportFilter_update(ReportFilter_Channel_Battery, dmSensorPacket->batt);
+            ReportFilter_update(ReportFilter_Channel_Temp, dmSensorPacket->Temp);
+            ReportFilter_update(ReportFilter_Channel_Hum, dmSensorPacket->Hum);
+            ReportFilter_update(ReportFilter_Channel_Button, dmSensorPacket->button);
+            ReportFilter_update(ReportFilter_Channel_PowerPolicy, dmSensorPacket->powerPolicy);
+
+            if (ReportFilter_isReportDue())
             {
-                //calculate time since last reading in 0.1s units
-                dmSensorPacket.time100MiliSec += ((currentTicks - prevTicks) * Clock_tickPeriod) / 100000;
+                sendDmPacket(maxRetries, NORERADIO_ACK_TIMEOUT_TIME_MS);
             }
             else
             {
-                //calculate time since last reading in 0.1s units
-                dmSensorPacket.time100MiliSec += ((prevTicks - currentTicks) * Clock_tickPeriod) / 100000;
+                /* Nothing worth sending, leave the radio off */
+                returnRadioOperationStatus(NodeRadioStatus_Suppressed);
             }
-            prevTicks = currentTicks;
-
-            dmSensorPacket.batt = AONBatMonBatteryVoltageGet();
-            dmSensorPacket.adcValue = adcData;
-            dmSensorPacket.button = !PIN_getInputValue(Board_BUTTON0);
-            dmSensorPacket.Temp = *test.t;
-            dmSensorPacket.Hum = *test.h;
-
-
-            sendDmPacket(dmSensorPacket, NODERADIO_MAX_RETRIES, NORERADIO_ACK_TIMEOUT_TIME_MS);
         }
 
         /* If we get an ACK from the concentrator */
         if (events & RADIO_EVENT_DATA_ACK_RECEIVED)
         {
+            /* Follow the coordinator GPS time */
+            if (ackNetworkTimeMs != RADIO_NETWORK_TIME_UNKNOWN)
+            {
+                NetworkTime_synchronize(ackNetworkTimeMs, ackRxTime);
+            }
+
+            /* The coordinator now has these values */
+            ReportFilter_markReported();
+
             returnRadioOperationStatus(NodeRadioStatus_Success);
         }
 
@@ -249,6 +289,12 @@ static void nodeRadioTaskFunction(UArg arg0, UArg arg1)
     }
 }
 
+void NodeRadioTask_setMaxRetries(uint8_t retries)
+{
+    /* Used from the next packet on */
+    maxRetries = retries;
+}
+
 enum NodeRadioOperationStatus NodeRadioTask_sendAdcData(uint16_t data)
 {
     enum NodeRadioOperationStatus status;
@@ -274,6 +320,37 @@ enum NodeRadioOperationStatus NodeRadioTask_sendAdcData(uint16_t data)
     return status;
 }
 
+static void initReportFilter(void)
+{
+    struct ReportFilterChannelConfig config;
+
+    ReportFilter_init(NODERADIO_REPORT_HEARTBEAT_MS);
+
+    config.relDeadbandPerMille = 0;
+
+    config.absDeadband = NODERADIO_ADC_DEADBAND;
+    config.hysteresis = NODERADIO_ADC_HYSTERESIS;
+    ReportFilter_setChannelConfig(ReportFilter_Channel_Adc, &config);
+
+    config.absDeadband = NODERADIO_BATT_DEADBAND;
+    config.hysteresis = NODERADIO_BATT_HYSTERESIS;
+    ReportFilter_setChannelConfig(ReportFilter_Channel_Battery, &config);
+
+    config.absDeadband = NODERADIO_TEMP_DEADBAND;
+    config.hysteresis = NODERADIO_TEMP_HYSTERESIS;
+    ReportFilter_setChannelConfig(ReportFilter_Channel_Temp, &config);
+
+    config.absDeadband = NODERADIO_HUM_DEADBAND;
+    config.hysteresis = NODERADIO_HUM_HYSTERESIS;
+    ReportFilter_setChannelConfig(ReportFilter_Channel_Hum, &config);
+
+    /* Every button press and power policy change is reported */
+    config.absDeadband = 0;
+    config.hysteresis = 0;
+    ReportFilter_setChannelConfig(ReportFilter_Channel_Button, &config);
+    ReportFilter_setChannelConfig(ReportFilter_Channel_PowerPolicy, &config);
+}
+
 static void returnRadioOperationStatus(enum NodeRadioOperationStatus result)
 {
     /* Save result */
@@ -283,47 +360,37 @@ static void returnRadioOperationStatus(enum NodeRadioOperationStatus result)
     Semaphore_post(radioResultSemHandle);
 }
 
-static void sendDmPacket(struct DualModeSensorPacket sensorPacket, uint8_t maxNumberOfRetries, uint32_t ackTimeoutMs)
+static void sendDmPacket(uint8_t maxNumberOfRetries, uint32_t ackTimeoutMs)
 {
     /* Set destination address in EasyLink API */
-    currentRadioOperation.easyLinkTxPacket.dstAddr[0] = RADIO_COORDINATOR_ADDRESS;
+    currentRadioOperation.easyLinkTxBuffer.dstAddr[0] = RADIO_COORDINATOR_ADDRESS;
 
-    /* Copy ADC packet to payload
+    /* The packet is already in the payload of the TX buffer
      * Note that the EasyLink API will implcitily both add the length byte and the destination address byte. */
-    memcpy(currentRadioOperation.easyLinkTxPacket.payload, ((uint8_t*)&dmSensorPacket), sizeof(struct DualModeSensorPacket));
-    currentRadioOperation.easyLinkTxPacket.len = sizeof(struct DualModeSensorPacket);
+    currentRadioOperation.easyLinkTxBuffer.len = sizeof(struct DualModeSensorPacket);
 
     /* Setup retries */
     currentRadioOperation.maxNumberOfRetries = maxNumberOfRetries;
     currentRadioOperation.ackTimeoutMs = ackTimeoutMs;
     currentRadioOperation.retriesDone = 0;
-    EasyLink_setCtrl(EasyLink_Ctrl_AsyncRx_TimeOut, EasyLink_ms_To_RadioTime(ackTimeoutMs));
 
-    /* Send packet  */
-    if (EasyLink_transmit(&currentRadioOperation.easyLinkTxPacket) != EasyLink_Status_Success)
+    /* Send packet and enter RX right after it on the radio core */
+    EasyLink_setCtrl(EasyLink_Ctrl_Next_Idle_TimeOut, NODERADIO_EXCHANGE_IDLE_TIMEOUT_US);
+    if (EasyLink_transmitBufferAndReceiveAsync(&currentRadioOperation.easyLinkTxBuffer,
+            EasyLink_ms_To_RadioTime(ackTimeoutMs), rxDoneCallback) != EasyLink_Status_Success)
     {
-        System_abort("EasyLink_transmit failed");
-    }
-
-    /* Enter RX */
-    if (EasyLink_receiveAsync(rxDoneCallback, 0) != EasyLink_Status_Success)
-    {
-        System_abort("EasyLink_receiveAsync failed");
+        System_abort("EasyLink_transmitBufferAndReceiveAsync failed");
     }
 }
 
 static void resendPacket()
 {
-    /* Send packet  */
-    if (EasyLink_transmit(&currentRadioOperation.easyLinkTxPacket) != EasyLink_Status_Success)
-    {
-        System_abort("EasyLink_transmit failed");
-    }
-
-    /* Enter RX and wait for ACK with timeout */
-    if (EasyLink_receiveAsync(rxDoneCallback, 0) != EasyLink_Status_Success)
+    /* Send packet and wait for ACK with timeout */
+    EasyLink_setCtrl(EasyLink_Ctrl_Next_Idle_TimeOut, NODERADIO_EXCHANGE_IDLE_TIMEOUT_US);
+    if (EasyLink_transmitBufferAndReceiveAsync(&currentRadioOperation.easyLinkTxBuffer,
+            EasyLink_ms_To_RadioTime(currentRadioOperation.ackTimeoutMs), rxDoneCallback) != EasyLink_Status_Success)
     {
-        System_abort("EasyLink_receiveAsync failed");
+        System_abort("EasyLink_transmitBufferAndReceiveAsync failed");
     }
 
     /* Increase retries by one */
@@ -333,6 +400,7 @@ static void resendPacket()
 static void rxDoneCallback(EasyLink_RxPacket * rxPacket, EasyLink_Status status)
 {
     struct PacketHeader* packetHeader;
+    struct AckPacket ackPacket;
 
     /* If this callback is called because of a packet received */
     if (status == EasyLink_Status_Success)
@@ -343,6 +411,15 @@ static void rxDoneCallback(EasyLink_RxPacket * rxPacket, EasyLink_Status status)
         /* Check if this is an ACK packet */
         if (packetHeader->packetType == RADIO_PACKET_TYPE_ACK_PACKET)
         {
+            /* Keep the network time for the task, older coordinators send only the header */
+            ackNetworkTimeMs = RADIO_NETWORK_TIME_UNKNOWN;
+            if (rxPacket->len >= sizeof(struct AckPacket))
+            {
+                ackRxTime = EasyLink_extendAbsTime(rxPacket->absTime);
+                memcpy(&ackPacket, rxPacket->payload, sizeof(struct AckPacket));
+                ackNetworkTimeMs = ackPacket.networkTimeMs;
+            }
+
             /* Signal ACK packet received */
             Event_post(radioOperationEventHandle, RADIO_EVENT_DATA_ACK_RECEIVED);
         }
@@ -361,8 +438,8 @@ static void rxDoneCallback(EasyLink_RxPacket * rxPacket, EasyLink_Status status)
     }
     else
     {
-        /* The Ack receiption may have been corrupted causing an error.
-         * Treat this as a timeout
+        /* The Ack receiption may have been corrupted, or the packet was
+         * not sent, causing an error. Treat this as a timeout
          */
         Event_post(radioOperationEventHandle, RADIO_EVENT_ACK_TIMEOUT);
     }
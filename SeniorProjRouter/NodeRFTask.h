@@ -41,12 +41,19 @@ enum NodeRadioOperationStatus {
     NodeRadioStatus_Success,
     NodeRadioStatus_Failed,
     NodeRadioStatus_FailedNotConnected,
+    NodeRadioStatus_Suppressed,
 };
 
 /* Initializes the NodeRadioTask and creates all TI-RTOS objects */
 void NodeRadioTask_init(void);
 
-/* Sends an ADC value to the concentrator */
+/* Sets the number of retries for each packet that is not acknowledged */
+void NodeRadioTask_setMaxRetries(uint8_t maxRetries);
+
+/* Sends an ADC value to the concentrator.
+ *
+ * Returns NodeRadioStatus_Suppressed without keying the radio if no channel crossed its
+ * report threshold and the heartbeat has not expired. */
 enum NodeRadioOperationStatus NodeRadioTask_sendAdcData(uint16_t data);
 
 #endif /* TASKS_NODERADIOTASKTASK_H_ */
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "NodeScheduler.h"
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+
+/***** Defines *****/
+#define NODESCHEDULER_TASK_STACK_SIZE 1024
+#define NODESCHEDULER_TASK_PRIORITY   2
+
+#define NODESCHEDULER_EVENT_ALL             0xFFFFFFFF
+#define NODESCHEDULER_EVENT_WINDOW          (uint32_t)(1 << 0)
+#define NODESCHEDULER_EVENT_RESCHEDULE      (uint32_t)(1 << 1)
+
+#define NodeScheduler_ms_To_Ticks(ms) ((uint32_t)(((uint64_t)(ms) * 1000) / Clock_tickPeriod))
+
+/* Signed difference so tick counter wrap around is handled */
+#define NodeScheduler_isBefore(a, b) ((int32_t)((a) - (b)) < 0)
+
+
+/***** Variable declarations *****/
+static Task_Params nodeSchedulerTaskParams;
+Task_Struct nodeSchedulerTask;    /* not static so you can see in ROV */
+static uint8_t nodeSchedulerTaskStack[NODESCHEDULER_TASK_STACK_SIZE];
+Event_Struct nodeSchedulerEvent;  /* not static so you can see in ROV */
+static Event_Handle nodeSchedulerEventHandle;
+
+/* One shot clock that opens the next wake window */
+Clock_Struct nodeSchedulerClock;  /* not static so you can see in ROV */
+static Clock_Handle nodeSchedulerClockHandle;
+
+static struct NodeSchedulerJob* jobList;
+static uint32_t periodTicks;
+static uint32_t nextWindowTicks;    /* Due tick of the next periodic window */
+static uint32_t windowTicks;        /* Tick the clock was armed for */
+
+
+/***** Prototypes *****/
+static void nodeSchedulerTaskFunction(UArg arg0, UArg arg1);
+static void nodeSchedulerClockCallback(UArg arg0);
+static void addJob(struct NodeSchedulerJob* job);
+static void runWindow(void);
+static void armClock(void);
+
+
+/***** Function definitions *****/
+void NodeScheduler_init(uint32_t periodMs)
+{
+    NodeScheduler_setPeriod(periodMs);
+
+    /* Create event used internally for state changes */
+    Event_Params eventParam;
+    Event_Params_init(&eventParam);
+    Event_construct(&nodeSchedulerEvent, &eventParam);
+    nodeSchedulerEventHandle = Event_handle(&nodeSchedulerEvent);
+
+    /* Create the one shot clock used to open wake windows */
+    Clock_Params clkParams;
+    Clock_Params_init(&clkParams);
+    clkParams.period = 0;
+    clkParams.startFlag = FALSE;
+    Clock_construct(&nodeSchedulerClock, nodeSchedulerClockCallback, 1, &clkParams);
+    nodeSchedulerClockHandle = Clock_handle(&nodeSchedulerClock);
+
+    /* Create the scheduler task */
+    Task_Params_init(&nodeSchedulerTaskParams);
+    nodeSchedulerTaskParams.stackSize = NODESCHEDULER_TASK_STACK_SIZE;
+    nodeSchedulerTaskParams.priority = NODESCHEDULER_TASK_PRIORITY;
+    nodeSchedulerTaskParams.stack = &nodeSchedulerTaskStack;
+    Task_construct(&nodeSchedulerTask, nodeSchedulerTaskFunction, &nodeSchedulerTaskParams, NULL);
+}
+
+void NodeScheduler_addPeriodicJob(struct NodeSchedulerJob* job, NodeScheduler_JobFxn fxn,
+        enum NodeSchedulerStage stage, uint16_t periodWindows)
+{
+    job->fxn = fxn;
+    job->stage = stage;
+    job->periodWindows = periodWindows;
+    /* Run in the first window */
+    job->windowsLeft = 1;
+    job->deadlinePending = 0;
+    addJob(job);
+}
+
+void NodeScheduler_addDeadlineJob(struct NodeSchedulerJob* job, NodeScheduler_JobFxn fxn,
+        enum NodeSchedulerStage stage)
+{
+    job->fxn = fxn;
+    job->stage = stage;
+    job->periodWindows = 0;
+    job->windowsLeft = 0;
+    job->deadlinePending = 0;
+    addJob(job);
+}
+
+void NodeScheduler_setPeriod(uint32_t periodMs)
+{
+    uint32_t ticks = NodeScheduler_ms_To_Ticks(periodMs);
+
+    /* Windows are at least one tick apart, runWindow divides by the period */
+    periodTicks = (ticks != 0) ? ticks : 1;
+}
+
+void NodeScheduler_postDeadlineJob(struct NodeSchedulerJob* job, uint32_t deadlineMs)
+{
+    uint32_t deadlineTicks = Clock_getTicks() + NodeScheduler_ms_To_Ticks(deadlineMs);
+
+    UInt key = Hwi_disable();
+    if ((!job->deadlinePending) || NodeScheduler_isBefore(deadlineTicks, job->deadlineTicks))
+    {
+        job->deadlineTicks = deadlineTicks;
+    }
+    job->deadlinePending = 1;
+    Hwi_restore(key);
+
+    /* Let the scheduler task move the wake window if needed */
+    Event_post(nodeSchedulerEventHandle, NODESCHEDULER_EVENT_RESCHEDULE);
+}
+
+static void nodeSchedulerTaskFunction(UArg arg0, UArg arg1)
+{
+    /* Open the first window right away so every job starts with fresh data */
+    nextWindowTicks = Clock_getTicks();
+    windowTicks = nextWindowTicks;
+    runWindow();
+    armClock();
+
+    while (1)
+    {
+        /* Wait for an event */
+        uint32_t events = Event_pend(nodeSchedulerEventHandle, 0, NODESCHEDULER_EVENT_ALL, BIOS_WAIT_FOREVER);
+
+        /* The clock expired, either for the period or for a deadline */
+        if (events & NODESCHEDULER_EVENT_WINDOW)
+        {
+            runWindow();
+        }
+
+        armClock();
+    }
+}
+
+static void nodeSchedulerClockCallback(UArg arg0)
+{
+    Event_post(nodeSchedulerEventHandle, NODESCHEDULER_EVENT_WINDOW);
+}
+
+static void addJob(struct NodeSchedulerJob* job)
+{
+    struct NodeSchedulerJob** pos = &jobList;
+
+    /* Keep the list sorted by stage, jobs in the same stage run in registration order */
+    while ((*pos != NULL) && ((*pos)->stage <= job->stage))
+    {
+        pos = &(*pos)->next;
+    }
+    job->next = *pos;
+    *pos = job;
+}
+
+static void runWindow(void)
+{
+    struct NodeSchedulerJob* job;
+    uint8_t run;
+    uint8_t periodic;
+    uint32_t now = Clock_getTicks();
+    UInt key;
+
+    /* The clock may have posted just before armClock stopped it for a later tick */
+    if (NodeScheduler_isBefore(now, windowTicks))
+    {
+        return;
+    }
+
+    /* A window opened early for a deadline only runs the posted jobs */
+    periodic = !NodeScheduler_isBefore(now, nextWindowTicks);
+
+    for (job = jobList; job != NULL; job = job->next)
+    {
+        run = 0;
+
+        if (periodic && (job->periodWindows != 0))
+        {
+            if (--job->windowsLeft == 0)
+            {
+                job->windowsLeft = job->periodWindows;
+                run = 1;
+            }
+        }
+
+        key = Hwi_disable();
+        if (job->deadlinePending)
+        {
+            job->deadlinePending = 0;
+            run = 1;
+        }
+        Hwi_restore(key);
+
+        if (run)
+        {
+            job->fxn();
+        }
+    }
+
+    if (!periodic)
+    {
+        return;
+    }
+
+    /* The next window is a full period after this one was due. Counting from the due tick
+     * rather than from now keeps the job runtime and the wake up latency from adding up window
+     * after window. */
+    nextWindowTicks += periodTicks;
+
+    /* Windows missed altogether are skipped instead of being run back to back */
+    now = Clock_getTicks();
+    if (!NodeScheduler_isBefore(now, nextWindowTicks))
+    {
+        nextWindowTicks += (((now - nextWindowTicks) / periodTicks) + 1) * periodTicks;
+    }
+}
+
+static void armClock(void)
+{
+    struct NodeSchedulerJob* job;
+    uint32_t wakeTicks = nextWindowTicks;
+    uint32_t now;
+    UInt key;
+
+    key = Hwi_disable();
+    for (job = jobList; job != NULL; job = job->next)
+    {
+        if (job->deadlinePending && NodeScheduler_isBefore(job->deadlineTicks, wakeTicks))
+        {
+            wakeTicks = job->deadlineTicks;
+        }
+    }
+    Hwi_restore(key);
+    windowTicks = wakeTicks;
+
+    Clock_stop(nodeSchedulerClockHandle);
+
+    now = Clock_getTicks();
+    if (NodeScheduler_isBefore(now, wakeTicks))
+    {
+        Clock_setTimeout(nodeSchedulerClockHandle, wakeTicks - now);
+    }
+    else
+    {
+        /* Already late, open the window on the next tick */
+        Clock_setTimeout(nodeSchedulerClockHandle, 1);
+    }
+    Clock_start(nodeSchedulerClockHandle);
+}
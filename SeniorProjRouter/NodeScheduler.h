@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NODESCHEDULER_H_
+#define NODESCHEDULER_H_
+
+#include "stdint.h"
+
+typedef void (*NodeScheduler_JobFxn)(void);
+
+/* Jobs in a wake window run stage by stage, so samples are taken before they are transmitted */
+enum NodeSchedulerStage {
+    NodeScheduler_Stage_Sample,
+    NodeScheduler_Stage_Transmit,
+};
+
+/* Job descriptor, owned by the module registering the job.
+ *
+ * The fields are private to the scheduler and must not be touched after registration. */
+struct NodeSchedulerJob {
+    NodeScheduler_JobFxn fxn;
+    enum NodeSchedulerStage stage;
+    uint16_t periodWindows;
+    uint16_t windowsLeft;
+    uint8_t deadlinePending;
+    uint32_t deadlineTicks;
+    struct NodeSchedulerJob* next;
+};
+
+/* Initializes the scheduler and creates all TI-RTOS objects.
+ *
+ * All jobs run in the scheduler task inside a wake window, which is opened once every periodMs.
+ * A window may be opened earlier to meet the deadline of a deadline job. Such a window only runs
+ * the posted jobs, the periodic jobs and the next periodic window are not affected.
+ */
+void NodeScheduler_init(uint32_t periodMs);
+
+/* Registers a job that runs in every periodWindows'th wake window.
+ *
+ * Must be called before BIOS_start. */
+void NodeScheduler_addPeriodicJob(struct NodeSchedulerJob* job, NodeScheduler_JobFxn fxn,
+        enum NodeSchedulerStage stage, uint16_t periodWindows);
+
+/* Registers a job that only runs when posted with NodeScheduler_postDeadlineJob.
+ *
+ * Must be called before BIOS_start. */
+void NodeScheduler_addDeadlineJob(struct NodeSchedulerJob* job, NodeScheduler_JobFxn fxn,
+        enum NodeSchedulerStage stage);
+
+/* Changes the wake window period, periods shorter than one Clock tick are rounded up to one.
+ *
+ * The window already scheduled is kept, the new period applies from the window after it. When
+ * called from a job the new period applies from the current window on. */
+void NodeScheduler_setPeriod(uint32_t periodMs);
+
+/* Requests a job to run in a wake window no later than deadlineMs from now.
+ *
+ * Periodic jobs may be posted as well, they still only run once in that window. If the job is
+ * already pending the earlier deadline is kept. May be called from any context. */
+void NodeScheduler_postDeadlineJob(struct NodeSchedulerJob* job, uint32_t deadlineMs);
+
+#endif /* NODESCHEDULER_H_ */
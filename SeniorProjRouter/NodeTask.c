@@ -53,6 +53,7 @@
 #include "NodeTask.h"
 #include "NodeRFTask.h"
 #include "TempHum.h"
+#include "NodeScheduler.h"
 
 
 /***** Defines *****/
@@ -65,12 +66,15 @@
 /* A change mask of 0xFF0 means that changes in the lower 4 bits does not trigger a wakeup. */
 #define NODE_ADCTASK_CHANGE_MASK                    0xFF0
 
-/* Minimum slow Report interval is 50s (in units of samplingTime)*/
-#define NODE_ADCTASK_REPORTINTERVAL_SLOW                50
+/* No slow Report interval, periodic reports are sent from the NodeScheduler wake window */
+#define NODE_ADCTASK_REPORTINTERVAL_SLOW                0
 /* Minimum fast Report interval is 1s (in units of samplingTime) for 30s*/
 #define NODE_ADCTASK_REPORTINTERVAL_FAST                1
 #define NODE_ADCTASK_REPORTINTERVAL_FAST_DURIATION_MS   30000
 
+/* A changed ADC value is transmitted at the latest this long after it was sampled */
+#define NODE_ADC_CHANGE_DEADLINE_MS                     1000
+
 
 
 
@@ -81,6 +85,11 @@ static uint8_t nodeTaskStack[NODE_TASK_STACK_SIZE];
 Event_Struct nodeEvent;  /* not static so you can see in ROV */
 static Event_Handle nodeEventHandle;
 static uint16_t latestAdcValue;
+static struct NodeSchedulerJob transmitJob;
+static uint16_t adcFastReportInterval = NODE_ADCTASK_REPORTINTERVAL_FAST;
+static uint16_t adcChangeMask = NODE_ADCTASK_CHANGE_MASK;
+static volatile uint8_t fastReportActive;
+static uint8_t sceStarted;
 struct point test;
 
 /* Clock for the fast report timeout */
@@ -113,6 +122,7 @@ static void nodeTaskFunction(UArg arg0, UArg arg1);
 void fastReportTimeoutCallback(UArg arg0);
 void adcCallback(uint16_t adcValue);
 void buttonCallback(PIN_Handle handle, PIN_Id pinId);
+static void transmitSensorData(void);
 
 
 /***** Function definitions *****/
@@ -138,6 +148,9 @@ void NodeTask_init(void)
     nodeTaskParams.priority = NODE_TASK_PRIORITY;
     nodeTaskParams.stack = &nodeTaskStack;
     Task_construct(&nodeTask, nodeTaskFunction, &nodeTaskParams, NULL);
+
+    /* Transmit at the end of every wake window, the window is pulled in when the ADC value changes */
+    NodeScheduler_addPeriodicJob(&transmitJob, transmitSensorData, NodeScheduler_Stage_Transmit, 1);
 }
 
 static void nodeTaskFunction(UArg arg0, UArg arg1)
@@ -156,9 +169,11 @@ static void nodeTaskFunction(UArg arg0, UArg arg1)
     }
 
     /* Start the SCE ADC task with 1s sample period and reacting to change in ADC value. */
-    SceAdc_init(0x00010000, NODE_ADCTASK_REPORTINTERVAL_FAST, NODE_ADCTASK_CHANGE_MASK);
+    fastReportActive = 1;
+    SceAdc_init(0x00010000, adcFastReportInterval, adcChangeMask);
     SceAdc_registerAdcCallback(adcCallback);
     SceAdc_start();
+    sceStarted = 1;
 
     /* setup timeout for fast report timeout */
     Clock_setTimeout(fastReportTimeoutClockHandle,
@@ -185,18 +200,23 @@ static void nodeTaskFunction(UArg arg0, UArg arg1)
         /* Wait for event */
         uint32_t events = Event_pend(nodeEventHandle, 0, NODE_EVENT_ALL, BIOS_WAIT_FOREVER);
 
-        /* If new ADC value, send this data */
+        /* If new ADC value, send it in a wake window before the deadline */
         if (events & NODE_EVENT_NEW_ADC_VALUE) {
-            /* Toggle activity LED */
-            PIN_setOutputValue(ledPinHandle, NODE_ACTIVITY_LED,!PIN_getOutputValue(NODE_ACTIVITY_LED));
-
-            /* Send ADC value to concentrator */
-            NodeRadioTask_sendAdcData(latestAdcValue);
+            NodeScheduler_postDeadlineJob(&transmitJob, NODE_ADC_CHANGE_DEADLINE_MS);
         }
       //  printf("Global variable: %d\n", HumV);
     }
 }
 
+static void transmitSensorData(void)
+{
+    /* Toggle activity LED */
+    PIN_setOutputValue(ledPinHandle, NODE_ACTIVITY_LED,!PIN_getOutputValue(NODE_ACTIVITY_LED));
+
+    /* Send ADC value to concentrator */
+    NodeRadioTask_sendAdcData(latestAdcValue);
+}
+
 void adcCallback(uint16_t adcValue)
 {
     /* Save latest value */
@@ -219,7 +239,8 @@ void buttonCallback(PIN_Handle handle, PIN_Id pinId)
     if (PIN_getInputValue(Board_BUTTON0) == 0)
     {
         //start fast report and timeout
-        SceAdc_setReportInterval(NODE_ADCTASK_REPORTINTERVAL_FAST, NODE_ADCTASK_CHANGE_MASK);
+        fastReportActive = 1;
+        SceAdc_setReportInterval(adcFastReportInterval, adcChangeMask);
         Clock_start(fastReportTimeoutClockHandle);
     }
 }
@@ -227,5 +248,19 @@ void buttonCallback(PIN_Handle handle, PIN_Id pinId)
 void fastReportTimeoutCallback(UArg arg0)
 {
     //stop fast report
-    SceAdc_setReportInterval(NODE_ADCTASK_REPORTINTERVAL_SLOW, NODE_ADCTASK_CHANGE_MASK);
+    fastReportActive = 0;
+    SceAdc_setReportInterval(NODE_ADCTASK_REPORTINTERVAL_SLOW, adcChangeMask);
+}
+
+void NodeTask_setAdcReportConfig(uint16_t fastReportInterval, uint16_t changeMask)
+{
+    adcFastReportInterval = fastReportInterval;
+    adcChangeMask = changeMask;
+
+    /* If the SCE is not started yet the new values are used by SceAdc_init */
+    if (sceStarted)
+    {
+        SceAdc_setReportInterval(fastReportActive ? adcFastReportInterval : NODE_ADCTASK_REPORTINTERVAL_SLOW,
+                adcChangeMask);
+    }
 }
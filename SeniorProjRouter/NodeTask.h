@@ -36,4 +36,9 @@
 /* Initializes the Node Task and creates all TI-RTOS objects */
 void NodeTask_init(void);
 
+/* Sets the SCE ADC fast report interval and change mask.
+ *
+ * Takes effect immediately, the fast report interval is used while fast reporting is active. */
+void NodeTask_setAdcReportConfig(uint16_t fastReportInterval, uint16_t adcChangeMask);
+
 #endif /* TASKS_NODETASK_H_ */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "ReportFilter.h"
+
+#include <xdc/std.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sysbios/knl/Clock.h>
+
+
+/***** Type declarations *****/
+struct ReportFilterChannelState {
+    struct ReportFilterChannelConfig config;
+    int32_t latestValue;
+    int32_t reportedValue;
+    int8_t lastDirection;
+};
+
+
+/***** Variable declarations *****/
+static struct ReportFilterChannelState channels[ReportFilter_Channel_Count];
+static uint32_t heartbeatTicks;
+static uint32_t lastReportTicks;
+static uint8_t hasReported;
+
+
+/***** Prototypes *****/
+static uint8_t isChannelDue(struct ReportFilterChannelState* channel);
+
+
+/***** Function definitions *****/
+void ReportFilter_init(uint32_t heartbeatMs)
+{
+    memset(channels, 0, sizeof(channels));
+    hasReported = 0;
+    lastReportTicks = Clock_getTicks();
+    ReportFilter_setHeartbeatInterval(heartbeatMs);
+}
+
+void ReportFilter_setChannelConfig(enum ReportFilterChannel channel, const struct ReportFilterChannelConfig* config)
+{
+    if (channel < ReportFilter_Channel_Count)
+    {
+        channels[channel].config = *config;
+    }
+}
+
+void ReportFilter_setHeartbeatInterval(uint32_t heartbeatMs)
+{
+    /* Clock_tickPeriod is in us */
+    heartbeatTicks = (uint32_t)(((uint64_t)heartbeatMs * 1000) / Clock_tickPeriod);
+}
+
+void ReportFilter_update(enum ReportFilterChannel channel, int32_t value)
+{
+    if (channel < ReportFilter_Channel_Count)
+    {
+        channels[channel].latestValue = value;
+    }
+}
+
+uint8_t ReportFilter_isReportDue(void)
+{
+    uint8_t i;
+
+    /* Nothing has been sent yet, so the coordinator has no values at all */
+    if (!hasReported)
+    {
+        return 1;
+    }
+
+    /* Unsigned subtraction also handles the tick counter wrapping */
+    if ((heartbeatTicks != 0) && ((Clock_getTicks() - lastReportTicks) >= heartbeatTicks))
+    {
+        return 1;
+    }
+
+    for (i = 0; i < ReportFilter_Channel_Count; i++)
+    {
+        if (isChannelDue(&channels[i]))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void ReportFilter_markReported(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < ReportFilter_Channel_Count; i++)
+    {
+        /* Remember the direction of the change so a reversal has to overcome the hysteresis */
+        if (channels[i].latestValue > channels[i].reportedValue)
+        {
+            channels[i].lastDirection = 1;
+        }
+        else if (channels[i].latestValue < channels[i].reportedValue)
+        {
+            channels[i].lastDirection = -1;
+        }
+        channels[i].reportedValue = channels[i].latestValue;
+    }
+
+    lastReportTicks = Clock_getTicks();
+    hasReported = 1;
+}
+
+static uint8_t isChannelDue(struct ReportFilterChannelState* channel)
+{
+    int32_t delta = channel->latestValue - channel->reportedValue;
+    uint32_t threshold;
+    uint32_t relThreshold;
+    int8_t direction;
+
+    if (delta == 0)
+    {
+        return 0;
+    }
+    direction = (delta > 0) ? 1 : -1;
+
+    threshold = channel->config.absDeadband;
+    relThreshold = ((uint32_t)abs(channel->reportedValue) * channel->config.relDeadbandPerMille) / 1000;
+    if (relThreshold > threshold)
+    {
+        threshold = relThreshold;
+    }
+
+    /* Moving back towards where we came from needs to overcome the hysteresis as well */
+    if ((channel->lastDirection != 0) && (direction != channel->lastDirection))
+    {
+        threshold += channel->config.hysteresis;
+    }
+
+    return ((uint32_t)abs(delta) >= threshold) ? 1 : 0;
+}
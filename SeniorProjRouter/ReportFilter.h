@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef REPORTFILTER_H_
+#define REPORTFILTER_H_
+
+#include "stdint.h"
+
+/* Channels that are evaluated before a sensor packet is transmitted */
+enum ReportFilterChannel {
+    ReportFilter_Channel_Adc,
+    ReportFilter_Channel_Battery,
+    ReportFilter_Channel_Temp,
+    ReportFilter_Channel_Hum,
+    ReportFilter_Channel_Button,
+    ReportFilter_Channel_PowerPolicy,
+    ReportFilter_Channel_Count,
+};
+
+/* Per channel change thresholds.
+ *
+ * A channel is due for reporting when the new value differs from the last reported value by at
+ * least the deadband, which is the larger of absDeadband (in channel units) and relDeadbandPerMille
+ * (in 1/1000 of the last reported value). If the change is in the opposite direction of the last
+ * reported change, hysteresis is added to the deadband so a value hovering around a threshold
+ * does not key the radio on every sample. A deadband of 0 reports every change.
+ */
+struct ReportFilterChannelConfig {
+    uint16_t absDeadband;
+    uint16_t relDeadbandPerMille;
+    uint16_t hysteresis;
+};
+
+/* Initializes the report filter.
+ *
+ * All channels start with a deadband of 0 and no last reported value, so the first call to
+ * ReportFilter_isReportDue after init always returns 1. heartbeatMs is the maximum time between
+ * two reports, 0 disables the heartbeat.
+ */
+void ReportFilter_init(uint32_t heartbeatMs);
+
+/* Sets the thresholds of one channel. */
+void ReportFilter_setChannelConfig(enum ReportFilterChannel channel, const struct ReportFilterChannelConfig* config);
+
+/* Sets the maximum-silence heartbeat interval in ms, 0 disables the heartbeat. */
+void ReportFilter_setHeartbeatInterval(uint32_t heartbeatMs);
+
+/* Stores the latest sampled value of a channel. */
+void ReportFilter_update(enum ReportFilterChannel channel, int32_t value);
+
+/* Returns 1 if any channel crossed its threshold or the heartbeat expired, else 0. */
+uint8_t ReportFilter_isReportDue(void);
+
+/* Marks the latest sampled values as reported.
+ *
+ * Should only be called once the report was acknowledged, so a failed transmission is
+ * retried on the next sample.
+ */
+void ReportFilter_markReported(void);
+
+#endif /* REPORTFILTER_H_ */
@@ -51,6 +51,25 @@
 /* Board Header files */
 #include "Board.h"
 
+#include "NodeScheduler.h"
+#include "BatteryPolicy.h"
+#include "SensorBus.h"
+
+/* One wake window for sampling and transmitting every 30s, stretched as the battery drops */
+#define NODE_SCHEDULER_PERIOD_MS 30000
+
+/* Battery policy levels, battery voltages are in 1/256 V */
+#define NODE_BATTERY_HYSTERESIS 13      //~50mV
+
+static const struct BatteryPolicyParams batteryPolicyTable[BatteryPolicy_Level_Count] = {
+    /* Normal: window every 30s, fast ADC reports every sample, HTU21D every window, 2 retries */
+    { .enterBelowBatt = 0,   .schedulerPeriodMs = NODE_SCHEDULER_PERIOD_MS, .adcFastReportInterval = 1,  .adcChangeMask = 0xFF0, .tempHumPeriodWindows = 1, .maxRetries = 2 },
+    /* Conserve: below 2.7V, window every 60s, HTU21D every 2 minutes */
+    { .enterBelowBatt = 691, .schedulerPeriodMs = 60000,                    .adcFastReportInterval = 5,  .adcChangeMask = 0xFE0, .tempHumPeriodWindows = 2, .maxRetries = 1 },
+    /* Critical: below 2.4V, window every 150s, HTU21D every 5 minutes */
+    { .enterBelowBatt = 614, .schedulerPeriodMs = 150000,                   .adcFastReportInterval = 10, .adcChangeMask = 0xFC0, .tempHumPeriodWindows = 2, .maxRetries = 0 },
+};
+
 
 
 /*
@@ -65,9 +84,12 @@ int main(void)
     // Board_initSPI();
     //Board_initUART();
     // Board_initWatchdog();
+    NodeScheduler_init(NODE_SCHEDULER_PERIOD_MS);   //Must be first, the other modules register jobs
     NodeRadioTask_init();
     NodeTask_init();
-    TempHum_init();                     //Start Temp/Hum thread
+    SensorBus_init();                   //Must be before the I2C sensor drivers register
+    TempHum_init();                     //Register the HTU21D with the sensor bus
+    BatteryPolicy_init(batteryPolicyTable, NODE_BATTERY_HYSTERESIS);
 
     /* Start BIOS */
     BIOS_start();
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/***** Includes *****/
+#include "SensorBus.h"
+#include "NodeScheduler.h"
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include <ti/drivers/I2C.h>
+
+/* Board Header files */
+#include "Board.h"
+
+
+/***** Defines *****/
+#define SensorBus_us_To_Ticks(us) (((us) + Clock_tickPeriod - 1) / Clock_tickPeriod)
+
+
+/***** Variable declarations *****/
+static struct SensorBusDriver* driverList;
+static struct NodeSchedulerJob busJob;
+uint32_t sensorBusSessions;     /* not static so you can see in ROV */
+uint32_t sensorBusOpenErrors;   /* not static so you can see in ROV */
+
+
+/***** Prototypes *****/
+static void runSession(void);
+static bool selectDueDrivers(void);
+static bool triggerConversions(I2C_Handle handle, uint8_t index, uint32_t* longestUs);
+static void readConversions(I2C_Handle handle, uint8_t index);
+
+
+/***** Function definitions *****/
+void SensorBus_init(void)
+{
+    /* The bus job checks every window which drivers are due */
+    NodeScheduler_addPeriodicJob(&busJob, runSession, NodeScheduler_Stage_Sample, 1);
+}
+
+void SensorBus_addDriver(struct SensorBusDriver* driver, uint16_t periodWindows)
+{
+    struct SensorBusDriver** pos = &driverList;
+
+    driver->periodWindows = periodWindows;
+    /* Sample in the first window */
+    driver->windowsLeft = 1;
+    driver->active = 0;
+    driver->pending = 0;
+    driver->errors = 0;
+
+    /* Append so drivers are triggered in registration order */
+    while (*pos != NULL)
+    {
+        pos = &(*pos)->next;
+    }
+    driver->next = NULL;
+    *pos = driver;
+}
+
+void SensorBus_setDriverPeriod(struct SensorBusDriver* driver, uint16_t periodWindows)
+{
+    /* Drivers are only touched from the scheduler task, like the bus job itself */
+    driver->periodWindows = periodWindows;
+
+    /* A disabled driver has no windows left, restart its count or the decrement would wrap */
+    if ((driver->windowsLeft == 0) || (driver->windowsLeft > periodWindows))
+    {
+        driver->windowsLeft = periodWindows;
+    }
+}
+
+uint32_t SensorBus_getDriverErrors(struct SensorBusDriver* driver)
+{
+    return driver->errors;
+}
+
+static void runSession(void)
+{
+    I2C_Handle handle;
+    I2C_Params params;
+    struct SensorBusDriver* driver;
+    uint32_t longestUs;
+    uint8_t index;
+
+    if (!selectDueDrivers())
+    {
+        return;
+    }
+
+    /* One I2C session per window, closing it releases the power constraint while we sleep */
+    I2C_Params_init(&params);
+    params.bitRate = I2C_400kHz;
+    handle = I2C_open(Board_I2C, &params);
+    if (!handle)
+    {
+        sensorBusOpenErrors++;
+        System_printf("I2C did not open");
+        return;
+    }
+    sensorBusSessions++;
+
+    for (driver = driverList; driver != NULL; driver = driver->next)
+    {
+        if (driver->active && (driver->prepare != NULL) && !driver->prepare(driver, handle))
+        {
+            driver->errors++;
+            driver->active = 0;
+        }
+    }
+
+    /* Conversion index n of every driver runs at the same time, one sleep per index */
+    for (index = 0; ; index++)
+    {
+        longestUs = 0;
+        if (!triggerConversions(handle, index, &longestUs))
+        {
+            break;
+        }
+
+        Task_sleep(SensorBus_us_To_Ticks(longestUs));   //Sleep instead of clock stretching while the sensors convert
+
+        readConversions(handle, index);
+    }
+
+    I2C_close(handle);
+}
+
+static bool selectDueDrivers(void)
+{
+    struct SensorBusDriver* driver;
+    bool anyDue = false;
+
+    for (driver = driverList; driver != NULL; driver = driver->next)
+    {
+        driver->active = 0;
+        if ((driver->periodWindows != 0) && (--driver->windowsLeft == 0))
+        {
+            driver->windowsLeft = driver->periodWindows;
+            driver->active = 1;
+            anyDue = true;
+        }
+    }
+
+    return anyDue;
+}
+
+static bool triggerConversions(I2C_Handle handle, uint8_t index, uint32_t* longestUs)
+{
+    struct SensorBusDriver* driver;
+    const struct SensorBusConversion* conversion;
+    I2C_Transaction i2cTransaction;
+    bool anyTriggered = false;
+
+    for (driver = driverList; driver != NULL; driver = driver->next)
+    {
+        driver->pending = 0;
+        if (!driver->active || (index >= driver->numConversions))
+        {
+            continue;
+        }
+
+        /* Keep going with the other drivers, a sensor that fails once stays out of this session */
+        conversion = &driver->conversions[index];
+        i2cTransaction.slaveAddress = driver->slaveAddress;
+        i2cTransaction.writeBuf = (void*)conversion->command;
+        i2cTransaction.writeCount = conversion->commandLength;
+        i2cTransaction.readBuf = NULL;
+        i2cTransaction.readCount = 0;
+        if (!I2C_transfer(handle, &i2cTransaction))
+        {
+            driver->errors++;
+            driver->active = 0;
+            continue;
+        }
+
+        driver->pending = 1;
+        anyTriggered = true;
+        if (conversion->conversionTimeUs > *longestUs)
+        {
+            *longestUs = conversion->conversionTimeUs;
+        }
+    }
+
+    return anyTriggered;
+}
+
+static void readConversions(I2C_Handle handle, uint8_t index)
+{
+    struct SensorBusDriver* driver;
+    const struct SensorBusConversion* conversion;
+    I2C_Transaction i2cTransaction;
+    uint8_t rxBuffer[SENSORBUS_MAX_READ_LENGTH];
+
+    for (driver = driverList; driver != NULL; driver = driver->next)
+    {
+        if (!driver->pending)
+        {
+            continue;
+        }
+        driver->pending = 0;
+
+        conversion = &driver->conversions[index];
+        i2cTransaction.slaveAddress = driver->slaveAddress;
+        i2cTransaction.writeBuf = NULL;
+        i2cTransaction.writeCount = 0;
+        i2cTransaction.readBuf = rxBuffer;
+        i2cTransaction.readCount = conversion->readLength;
+        if (!I2C_transfer(handle, &i2cTransaction))
+        {
+            driver->errors++;
+            driver->active = 0;
+            continue;
+        }
+
+        if (!conversion->decode(driver, rxBuffer))
+        {
+            /* Rejected readings do not stop the next conversion of the driver */
+            driver->errors++;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SENSORBUS_H_
+#define SENSORBUS_H_
+
+#include "stdint.h"
+#include <stdbool.h>
+#include <ti/drivers/I2C.h>
+
+#define SENSORBUS_MAX_COMMAND_LENGTH 2
+#define SENSORBUS_MAX_READ_LENGTH    6
+
+struct SensorBusDriver;
+
+/* Decodes the bytes read back after a conversion. Returns false to reject the reading. */
+typedef bool (*SensorBus_DecodeFxn)(struct SensorBusDriver* driver, const uint8_t* rxBuffer);
+
+/* Called at the start of a bus session before any conversion is triggered, e.g. to write a
+ * configuration register. Returns false to skip the driver in this session. */
+typedef bool (*SensorBus_PrepareFxn)(struct SensorBusDriver* driver, I2C_Handle handle);
+
+/* One conversion of a sensor: the command that starts it, how long it takes and how the
+ * result is read back and decoded */
+struct SensorBusConversion {
+    uint8_t command[SENSORBUS_MAX_COMMAND_LENGTH];
+    uint8_t commandLength;
+    uint8_t readLength;             /* Bytes read back once done, at most SENSORBUS_MAX_READ_LENGTH */
+    uint32_t conversionTimeUs;      /* Worst case conversion time, may be changed between sessions */
+    SensorBus_DecodeFxn decode;
+};
+
+/* Driver descriptor, owned by the sensor module registering it.
+ *
+ * Conversions of one driver run one after the other, since most sensors can only convert one
+ * quantity at a time. Conversions of different drivers run in parallel. The fields from
+ * periodWindows on are private to the bus and must not be touched after registration. */
+struct SensorBusDriver {
+    uint8_t slaveAddress;
+    const struct SensorBusConversion* conversions;
+    uint8_t numConversions;
+    SensorBus_PrepareFxn prepare;   /* Optional, may be NULL */
+    void* arg;                      /* Free for use by the driver */
+    uint16_t periodWindows;
+    uint16_t windowsLeft;
+    uint8_t active;
+    uint8_t pending;
+    uint32_t errors;
+    struct SensorBusDriver* next;
+};
+
+/* Initializes the sensor bus and registers the bus job with the NodeScheduler.
+ *
+ * In every wake window the bus opens I2C once, triggers the first conversion of every due
+ * driver, sleeps for the longest of them and then reads all results back. This is repeated
+ * until all conversions of all due drivers are done, so the time spent awake follows the
+ * slowest sensor instead of the sum of all sensors.
+ */
+void SensorBus_init(void);
+
+/* Registers a driver that is sampled in every periodWindows'th wake window.
+ *
+ * Must be called after SensorBus_init and before BIOS_start. */
+void SensorBus_addDriver(struct SensorBusDriver* driver, uint16_t periodWindows);
+
+/* Changes how often a driver is sampled, takes effect after its next session. 0 stops sampling. */
+void SensorBus_setDriverPeriod(struct SensorBusDriver* driver, uint16_t periodWindows);
+
+/* Returns the number of failed transfers and rejected readings of a driver */
+uint32_t SensorBus_getDriverErrors(struct SensorBusDriver* driver);
+
+#endif /* SENSORBUS_H_ */
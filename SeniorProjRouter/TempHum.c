@@ -31,10 +31,10 @@
  */
 
 /*
-This code utilizes the I2C protocol by opening the I2C driver and transmitting commands to the third party device (in this case I'm using the Adafruit HTU21D-F breakout board).
+This code drives the third party HTU21D device over I2C (in this case I'm using the Adafruit HTU21D-F breakout board).
 This is done by using the correct slave address (0x40), and connecting the pins correctly from the Adafruit device to the CC2650 launchpad.
-When the I2C driver is initialized and starts transmission, the TxBuffer contains the command and retrieves the data for temperature
-and humidity.
+The HTU21D is registered as a driver with the SensorBus, which sends the commands for temperature and humidity
+and hands the data read back to the decode functions below.
 */
 
 /* XDCtools Header files */
@@ -44,8 +44,6 @@ and humidity.
 
 /* BIOS Header files */
 #include <ti/sysbios/BIOS.h>
-#include <ti/sysbios/knl/Clock.h>
-#include <ti/sysbios/knl/Task.h>
 
 /* TI-RTOS Header files */
 #include <ti/drivers/I2C.h>
@@ -58,97 +56,200 @@ and humidity.
 /* Board Header files */
 #include "Board.h"
 #include <stdint.h>
+#include <stdlib.h>
 #include "TempHum.h"
+#include "SensorBus.h"
 
 struct point test;
-struct TempHum                                                               //Struct TempHum (buffers that are used throughout)
-{
-    uint8_t RxBuffer[2];
-    uint8_t TxBuffer[3];
-    float Temp[1];
-    float Humidity[1];
-
-};
 
-#define TASKSTACKSIZE   768
 #define BufferSize 100
 
-Task_Struct task0Struct;
-Char task0Stack[TASKSTACKSIZE];
+#define HTU21D_ADDRESS                  0x40
+#define HTU21D_TRIGGER_TEMP_NOHOLD      0xF3                                 //No hold master, so the bus is free while converting
+#define HTU21D_TRIGGER_HUM_NOHOLD       0xF5
+#define HTU21D_WRITE_USER_REG           0xE6
+#define HTU21D_READ_USER_REG            0xE7
+#define HTU21D_USER_REG_RES_MASK        0x81                                 //Resolution is bit 7 and bit 0 of the user register
+#define HTU21D_STATUS_MASK              0xFFFC                               //Two LSBs of a measurement are status bits
+#define HTU21D_CRC_POLYNOMIAL           0x31                                 //x^8 + x^5 + x^4 + 1
+#define HTU21D_READ_LENGTH              3                                    //MSB, LSB and CRC-8 of a measurement
 
 /* Pin driver handle */
 #include <ti/drivers/i2c/I2CCC26XX.h>
 
 /***** Prototypes *****/
+static bool prepareHtu21d(struct SensorBusDriver* driver, I2C_Handle handle);
+static bool decodeTemperature(struct SensorBusDriver* driver, const uint8_t* rxBuffer);
+static bool decodeHumidity(struct SensorBusDriver* driver, const uint8_t* rxBuffer);
+static bool checkMeasurement(const uint8_t* rxBuffer);
+static uint8_t crc8(const uint8_t * data, uint8_t len);
+static uint32_t tempConversionTimeUs(enum TempHumResolution res);
+static uint32_t humConversionTimeUs(enum TempHumResolution res);
+float Temperature(const uint8_t * rxBuffer);
+float Humidity(const uint8_t * rxBuffer);
 
 
 const float OffSet = -46.84;
 const float MultValue = 175.72;
 const float DivValue = 65536;
 
+static enum TempHumResolution resolution = TEMPHUM_DEFAULT_RESOLUTION;
+static bool resolutionChanged = true;                                        //Write the user register before the first measurement
+uint32_t tempHumCrcErrors;                                                   //not static so you can see in ROV
 
+static struct SensorBusConversion htu21dConversions[] = {                    //The HTU21D converts one quantity at a time
+    { .command = { HTU21D_TRIGGER_TEMP_NOHOLD }, .commandLength = 1, .readLength = HTU21D_READ_LENGTH, .decode = decodeTemperature },
+    { .command = { HTU21D_TRIGGER_HUM_NOHOLD },  .commandLength = 1, .readLength = HTU21D_READ_LENGTH, .decode = decodeHumidity },
+};
+
+static struct SensorBusDriver htu21dDriver = {
+    .slaveAddress = HTU21D_ADDRESS,                                          //Set slave address of HTU21D(F) sensor
+    .conversions = htu21dConversions,
+    .numConversions = sizeof(htu21dConversions) / sizeof(htu21dConversions[0]),
+    .prepare = prepareHtu21d,
+};
 
 
 
 
-void I2CBusProj(UArg arg0, UArg arg1)                                        //Start of I2C
+void TempHum_setResolution(enum TempHumResolution res)
+{
+    resolution = res;                                                        //Applied by the bus before its next measurement
+    htu21dConversions[0].conversionTimeUs = tempConversionTimeUs(res);
+    htu21dConversions[1].conversionTimeUs = humConversionTimeUs(res);
+    resolutionChanged = true;
+}
+
+void TempHum_setSampleInterval(uint16_t periodWindows)
+{
+    SensorBus_setDriverPeriod(&htu21dDriver, periodWindows);
+}
+
+enum TempHumResolution TempHum_getResolution(void)
+{
+    return resolution;
+}
+
+static bool prepareHtu21d(struct SensorBusDriver* driver, I2C_Handle handle)  //Writes the resolution once it was changed
 {
-    test.h = (char*) malloc(1);                                              //Allocate one byte to the heap and return pointer
-    test.t = (char*) malloc(1);                                              //Allocate one byte to the heap and return pointer
-    struct TempHum p;                                                        //Declare struct in I2CBusProj
-//  Display_Params D_params;                                                 //Setup LCD display
- // Display_Params_init(&D_params);
- // D_params.lineClearMode = DISPLAY_CLEAR_BOTH;
- // Display_Handle hDisplayLcd = Display_open(Display_Type_LCD, &D_params);
-
-    I2C_Handle      handle;                                                  //I2C initialization
-    I2C_Params      params;
     I2C_Transaction i2cTransaction;
+    uint8_t txBuffer[2];
+    uint8_t userReg;
 
-    I2C_Params_init(&params);
-    params.bitRate = I2C_400kHz;                                             //Frequency set to 400kHz
-    handle = I2C_open(Board_I2C, &params);
-    if (!handle)
+    if (!resolutionChanged)
     {
-        System_printf("I2C did not open");
+        return true;
     }
 
-    Task_sleep(10000000/ Clock_tickPeriod);                                  //Delay before I2C transfer
+    txBuffer[0] = HTU21D_READ_USER_REG;                                      //Read the user register so the reserved bits are kept
+    i2cTransaction.slaveAddress = driver->slaveAddress;
+    i2cTransaction.writeBuf = txBuffer;
+    i2cTransaction.writeCount = 1;
+    i2cTransaction.readBuf = &userReg;
+    i2cTransaction.readCount = 1;
+    if (!I2C_transfer(handle, &i2cTransaction))
+    {
+        return false;
+    }
 
-    while(1)
+    txBuffer[0] = HTU21D_WRITE_USER_REG;
+    txBuffer[1] = (userReg & ~HTU21D_USER_REG_RES_MASK) | (uint8_t)resolution;
+    i2cTransaction.writeCount = 2;
+    i2cTransaction.readBuf = NULL;
+    i2cTransaction.readCount = 0;
+    if (!I2C_transfer(handle, &i2cTransaction))
     {
-        Task_sleep(10000000/ Clock_tickPeriod);
-
-        p.TxBuffer[0] = 0xE3;                                           //Send command Trigger Temperature Measurement to obtain temperature data
-
-        i2cTransaction.slaveAddress = 0x40;                             //Set slave address of HTU21D(F) sensor
-        i2cTransaction.writeBuf = p.TxBuffer;                           //Set write buffer as TxBuffer
-        i2cTransaction.writeCount = 1;                                  //Send one byte of data (0xE3)
-        i2cTransaction.readBuf = p.RxBuffer;                            //Set read buffer as RxBuffer
-        i2cTransaction.readCount = 2;                                   //Read in two bytes of data for temperature
-        I2C_transfer(handle, &i2cTransaction);                          //Start transfer of bus
-        Temperature(&p);                                       //Call Temperature function to convert data to Fahrenheit
-      //  Display_print1(hDisplayLcd, 4, 2, "TEMP: %d (F)", p.Temp[0]);   //Display Fahrenheit data on LCD
-        *test.t =  p.Temp[0];
-        Task_sleep(10000000/ Clock_tickPeriod);
-
-        p.TxBuffer[0] = 0xE5;                                           //Send command Trigger Temperature Measurement to obtain temperature data
-
-        i2cTransaction.slaveAddress = 0x40;                                    //Set slave address of HTU21D(F) sensor
-        i2cTransaction.writeBuf = p.TxBuffer;                                  //Set write buffer as TxBuffer
-        i2cTransaction.writeCount = 1;                                         //Send one byte of data (0xE3)
-        i2cTransaction.readBuf = p.RxBuffer;                                   //Set read buffer as RxBuffer
-        i2cTransaction.readCount = 2;                                          //Read in two bytes of data for temperature
-        I2C_transfer(handle, &i2cTransaction);                                 //Start transfer of bus
-        Humidity(&p);                                                 //Call Temperature function to convert data to Fahrenheit
-     //   Display_print2(hDisplayLcd, 5, 2, "Hum:  %d%c", p.Humidity[0], '%');   //Display Fahrenheit data on LCD
-        *test.h =  p.Humidity[0];
-
-        Task_sleep(10000000/ Clock_tickPeriod);                                  //Delay before I2C transfer
-        free(test.h);                                                            //Free allocated memory and allow OS to use it
-        free(test.t);                                                            //This is important to avoid memory leaks!
+        return false;
     }
 
+    resolutionChanged = false;
+    return true;
+}
+
+static bool decodeTemperature(struct SensorBusDriver* driver, const uint8_t* rxBuffer)
+{
+    if (!checkMeasurement(rxBuffer))
+    {
+        return false;
+    }
+    *test.t = Temperature(rxBuffer);                                         //Only keep readings that passed the CRC check
+    return true;
+}
+
+static bool decodeHumidity(struct SensorBusDriver* driver, const uint8_t* rxBuffer)
+{
+    if (!checkMeasurement(rxBuffer))
+    {
+        return false;
+    }
+    *test.h = Humidity(rxBuffer);
+    return true;
+}
+
+static bool checkMeasurement(const uint8_t* rxBuffer)
+{
+    if (crc8(rxBuffer, 2) != rxBuffer[2])                                    //Reject corrupted readings instead of transmitting them
+    {
+        tempHumCrcErrors++;
+        return false;
+    }
+    return true;
+}
+
+static uint8_t crc8(const uint8_t * data, uint8_t len)                       //CRC-8 as specified in the HTU21D datasheet, initial value 0
+{
+    uint8_t crc = 0;
+    uint8_t i;
+    uint8_t bit;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x80)
+            {
+                crc = (crc << 1) ^ HTU21D_CRC_POLYNOMIAL;
+            }
+            else
+            {
+                crc = crc << 1;
+            }
+        }
+    }
+    return crc;
+}
+
+static uint32_t tempConversionTimeUs(enum TempHumResolution res)              //Max conversion times from the HTU21D datasheet
+{
+    switch (res)
+    {
+        case TempHum_Resolution_Rh8_T12:
+            return 13000;
+        case TempHum_Resolution_Rh10_T13:
+            return 25000;
+        case TempHum_Resolution_Rh11_T11:
+            return 7000;
+        case TempHum_Resolution_Rh12_T14:
+        default:
+            return 50000;
+    }
+}
+
+static uint32_t humConversionTimeUs(enum TempHumResolution res)
+{
+    switch (res)
+    {
+        case TempHum_Resolution_Rh8_T12:
+            return 3000;
+        case TempHum_Resolution_Rh10_T13:
+            return 5000;
+        case TempHum_Resolution_Rh11_T11:
+            return 8000;
+        case TempHum_Resolution_Rh12_T14:
+        default:
+            return 16000;
+    }
 }
 
 /*
@@ -156,25 +257,26 @@ void I2CBusProj(UArg arg0, UArg arg1)                                        //S
  */
 void TempHum_init(void)
 {
-    PIN_Handle ledPinHandle;
-    Task_Params taskParams;
-
     /* Call board init functions */
     Board_initI2C();
     // Board_initSPI();
     // Board_initUART();
     // Board_initWatchdog();
 
-    /* Construct heartBeat Task  thread */
-    Task_Params_init(&taskParams);
-    taskParams.arg0 = 1000000 / Clock_tickPeriod;
-    taskParams.stackSize = TASKSTACKSIZE;
-    taskParams.stack = &task0Stack;
-    Task_construct(&task0Struct, (Task_FuncPtr)I2CBusProj, &taskParams, NULL);
+    test.h = (char*) malloc(1);                                              //Allocate one byte to the heap and return pointer
+    test.t = (char*) malloc(1);                                              //Kept for the lifetime of the application
+    *test.h = 0;
+    *test.t = 0;
+
+    htu21dConversions[0].conversionTimeUs = tempConversionTimeUs(resolution);
+    htu21dConversions[1].conversionTimeUs = humConversionTimeUs(resolution);
+
+    /* Sample in every wake window, before the radio transmits */
+    SensorBus_addDriver(&htu21dDriver, 1);
 }
 
 
-void Temperature(struct TempHum * b)                     //Converts data to Celsius, then converts Celsius to Fahrenheit
+float Temperature(const uint8_t * rxBuffer)              //Converts data to Celsius, then converts Celsius to Fahrenheit
 {
     unsigned int tVal;
     unsigned int val2;
@@ -182,17 +284,17 @@ void Temperature(struct TempHum * b)                     //Converts data to Cels
     float temp;
                                                          //We are using two bytes of data that we read from I2C, we need to shift the first byte
                                                          //and add the second byte to that value
-    val = b->RxBuffer[0] << 8;                           //Shift data by 8 bits (1 byte) e.g., 60 (0110 0000) would be shifted 0110 0000 0000 0000
-    val2 = b->RxBuffer[1];                               //No shift required e.g., if value is 50 decimal, then in binary it would be 0000 0000 0101 0000
-    tVal = val + val2;                                   //Add both values (first and second byte)
+    val = rxBuffer[0] << 8;                              //Shift data by 8 bits (1 byte) e.g., 60 (0110 0000) would be shifted 0110 0000 0000 0000
+    val2 = rxBuffer[1];                                  //No shift required e.g., if value is 50 decimal, then in binary it would be 0000 0000 0101 0000
+    tVal = (val + val2) & HTU21D_STATUS_MASK;            //Add both values (first and second byte) and clear the status bits
 
 
     temp = OffSet + (MultValue * (tVal / DivValue));     //Convert data to celsius value (-46.85 + 175.72*(S_temp/2^16)
     temp = (temp * (1.8) + 32);                          //Convert C to F
-    b->Temp[0] = temp;                                   //Store result in memory
+    return temp;
 }
 
-void Humidity(struct TempHum * b)                     //Converts data to Celsius, then converts Celsius to Fahrenheit
+float Humidity(const uint8_t * rxBuffer)                 //Converts data to %RH
 {
     unsigned int tVal;
     unsigned int val2;
@@ -200,11 +302,11 @@ void Humidity(struct TempHum * b)                     //Converts data to Celsius
     float temp;
                                                          //We are using two bytes of data that we read from I2C, we need to shift the first byte
                                                          //and add the second byte to that value
-    val = b->RxBuffer[0] << 8;                           //Shift data by 8 bits (1 byte) e.g., 60 (0110 0000) would be shifted 0110 0000 0000 0000
-    val2 = b->RxBuffer[1];                               //No shift required e.g., if value is 50 decimal, then in binary it would be 0000 0000 0101 0000
-    tVal = val + val2;                                   //Add both values (first and second byte)
+    val = rxBuffer[0] << 8;                              //Shift data by 8 bits (1 byte) e.g., 60 (0110 0000) would be shifted 0110 0000 0000 0000
+    val2 = rxBuffer[1];                                  //No shift required e.g., if value is 50 decimal, then in binary it would be 0000 0000 0101 0000
+    tVal = (val + val2) & HTU21D_STATUS_MASK;            //Add both values (first and second byte) and clear the status bits
 
 
     temp = -6 + (125 * (tVal / DivValue));               //Convert data to decimal humidity value (-6 + 125*(S_hum/2^16)
-    b->Humidity[0] = temp;                               //Store result in memory
+    return temp;
 }
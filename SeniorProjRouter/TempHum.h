@@ -39,4 +39,27 @@ char * h;               //humidity pointer
 char * t;               //temperature pointer
 };
 
+/* HTU21D measurement resolutions (user register bits 7 and 0).
+ * Lower resolutions shorten the conversion time, e.g. T14 takes up to 50 ms and T11 up to 7 ms. */
+enum TempHumResolution {
+    TempHum_Resolution_Rh12_T14 = 0x00,
+    TempHum_Resolution_Rh8_T12 = 0x01,
+    TempHum_Resolution_Rh10_T13 = 0x80,
+    TempHum_Resolution_Rh11_T11 = 0x81,
+};
+
+#define TEMPHUM_DEFAULT_RESOLUTION TempHum_Resolution_Rh12_T14
+
+/* Initializes the I2C bus and registers the HTU21D driver with the SensorBus */
+void TempHum_init(void);
+
+/* Sets the HTU21D resolution, it is written to the sensor before the next measurement */
+void TempHum_setResolution(enum TempHumResolution res);
+
+/* Sets how often the HTU21D is sampled, in NodeScheduler wake windows */
+void TempHum_setSampleInterval(uint16_t periodWindows);
+
+/* Returns the currently selected HTU21D resolution */
+enum TempHumResolution TempHum_getResolution(void);
+
 #endif /* TempHum_H_ */
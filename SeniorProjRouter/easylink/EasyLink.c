@@ -39,6 +39,7 @@
 #include <driverlib/rf_prop_mailbox.h>
 #include <driverlib/rf_prop_cmd.h>
 #include <driverlib/chipinfo.h>
+#include <driverlib/aon_rtc.h>
 
 #include "smartrf_settings/smartrf_settings_predefined.h"
 #include "smartrf_settings/smartrf_settings.h"
@@ -47,6 +48,8 @@
 #include <xdc/runtime/Error.h>
 #include <ti/sysbios/BIOS.h>
 #include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Swi.h>
 
 #include <inc/hw_ccfg.h>
 #include <inc/hw_ccfg_simple_struct.h>
@@ -75,8 +78,20 @@ union setupCmd_t{
 
 #define EasyLink_CmdHandle_isValid(handle) (handle >= 0)
 
+//No override of the inactivity timeout for the next operation
+#define EASYLINK_IDLE_TIMEOUT_NONE        0xFFFFFFFF
+
+//Tx share of a command for the radio time statistics
+#define EASYLINK_RADIO_TIME_ALL_TX        0xFFFFFFFF
+#define EASYLINK_RADIO_TIME_ALL_RX        0
+
+//Channel blacklist, the ACK loss of a channel is kept in 1/256 units
+#define EASYLINK_HOP_LOSS_SHIFT           3     //Each result moves the loss by 1/8
+#define EASYLINK_HOP_BLACKLIST_LOSS       160   //About 60% of the ACKs lost
+#define EASYLINK_HOP_MIN_RESULTS          8     //Results before a channel can be blacklisted
+#define EASYLINK_HOP_PROBATION_RESULTS    512   //Results on other channels before a retry
+
 /***** Prototypes *****/
-static EasyLink_TxDoneCb txCb;
 static EasyLink_ReceiveCb rxCb;
 
 /***** Variable declarations *****/
@@ -135,20 +150,514 @@ static rfc_CMD_PROP_RX_ADV_t EasyLink_cmdPropRxAdv;
 // The table for setting the Rx Address Filters
 static uint8_t addrFilterTable[EASYLINK_MAX_ADDR_FILTERS * EASYLINK_MAX_ADDR_SIZE] = {0xaa};
 
+//Software address filter for the addresses that do not fit in addrFilterTable.
+//1 byte addresses are kept in a bitmap, longer ones are looked up in the
+//caller's sorted table
+static bool swAddrFilterEnabled = false;
+static uint8_t swAddrBitmap[256 / 8];
+static const uint8_t *swAddrTable = NULL;
+static uint8_t swAddrNum = 0;
+
 //Mutex for locking the RF driver resource
 static Semaphore_Handle busyMutex;
 
-//Handle for last Async command, which is needed by EasyLink_abort
+//Async Tx commands. Each has its own copy of the Tx command, and a buffer for
+//EasyLink_transmitAsync, so that several can be queued in the RF driver
+typedef struct {
+    rfc_CMD_PROP_TX_t cmd;
+    uint8_t buffer[1 + EASYLINK_MAX_ADDR_SIZE + EASYLINK_MAX_DATA_LENGTH];
+    EasyLink_TxDoneCb cb;
+    RF_CmdHandle cmdHndl;
+    uint64_t submitTime;
+    bool queued;            //Posted behind other commands
+    bool inUse;
+} TxCmdDesc;
+static TxCmdDesc txCmdPool[EASYLINK_NUM_TX_CMDS];
+
+//Tx command of a Tx and Rx chain while it runs, its status tells if the Rx ran
+static TxCmdDesc *pChainedTx = NULL;
+
+//Async Rx (or Tx and Rx chain) for the radio time statistics
+static uint64_t rxSubmitTime;
+static bool rxQueued;
+static uint32_t rxTxTime;
+
+//Inactivity timeout the RF driver uses, in us, and the override for the
+//next Tx or Rx
+static uint32_t appliedIdleTimeout;
+static uint32_t nextIdleTimeout = EASYLINK_IDLE_TIMEOUT_NONE;
+
+//Last 64 bit radio time handed out and the RTC value it was read at
+static uint64_t lastAbsTime64;
+static uint64_t lastRtc;
+static bool absTime64Valid = false;
+
+//End of the last Tx or Rx and the inactivity timeout that followed it
+static uint64_t lastCmdEndTime;
+static uint32_t lastCmdIdleTimeout;
+static bool lastCmdEndValid = false;
+
+//Statistics accumulated from the per command rxStatistics and Tx results
+static EasyLink_Stats radioStats;
+static EasyLink_RxEventCb rxEventCb = NULL;
+static uint32_t rxEventMask = 0;
+
+//Setup commands of the Phys that share the RF mode EasyLink_init opened
+//the driver with, for EasyLink_setPhy
+#define EASYLINK_NUM_PHYS   (EasyLink_Phy_2_4_200kbps2gfsk + 1)
+static union setupCmd_t phyCache[EASYLINK_NUM_PHYS];
+static bool phyCacheValid[EASYLINK_NUM_PHYS];
+
+//Channel plan and the FS command precomputed for each channel
+static uint32_t channelFreqs[EASYLINK_MAX_CHANNELS];
+static rfc_CMD_FS_t channelFs[EASYLINK_MAX_CHANNELS];
+static uint8_t numChannels = 0;
+
+//FS command the radio was last tuned with
+static rfc_CMD_FS_t *pCurrentFs = &EasyLink_cmdFs;
+
+//Channel hopping, the channel of a slot only depends on the seed, the slot
+//number and the blacklist. The hop FS is a copy so that a new channel plan
+//cannot change it while it is queued.
+static bool hoppingEnabled = false;
+static uint32_t hopSeed = 0;
+static rfc_CMD_FS_t hopFs;
+static volatile bool hopPending = false;
+
+//ACK loss of each channel of the plan and the blacklist derived from it
+static uint8_t channelLoss[EASYLINK_MAX_CHANNELS];
+static uint8_t channelResults[EASYLINK_MAX_CHANNELS];
+static uint16_t channelProbation[EASYLINK_MAX_CHANNELS];
+static uint32_t channelBlacklist = 0;
+
+//Handle for the Async Rx (or test mode) command, which is needed by EasyLink_abort
 static RF_CmdHandle asyncCmdHndl = EASYLINK_RF_CMD_HANDLE_INVALID;
 
+//Setup command and RF mode of a Phy, NULL if the chip does not support it
+static const RF_Mode* getPhySettings(EasyLink_PhyType phy, union setupCmd_t *pSetup)
+{
+    bool cc2650 = (ChipInfo_GetChipType() == CHIP_TYPE_CC2650);
+
+    switch (phy)
+    {
+        case EasyLink_Phy_Custom:
+            if (cc2650)
+            {
+                memcpy(&pSetup->setup, &RF_cmdPropRadioDivSetup, sizeof(rfc_CMD_PROP_RADIO_SETUP_t));
+            }
+            else
+            {
+                memcpy(&pSetup->divSetup, &RF_cmdPropRadioDivSetup, sizeof(rfc_CMD_PROP_RADIO_DIV_SETUP_t));
+            }
+            return &RF_prop;
+        case EasyLink_Phy_50kbps2gfsk:
+            if (!cc2650)
+            {
+                memcpy(&pSetup->divSetup, RF_pCmdPropRadioDivSetup_fsk, sizeof(rfc_CMD_PROP_RADIO_DIV_SETUP_t));
+                return RF_pProp_fsk;
+            }
+            break;
+        case EasyLink_Phy_625bpsLrm:
+            if (!cc2650)
+            {
+                memcpy(&pSetup->divSetup, RF_pCmdPropRadioDivSetup_lrm, sizeof(rfc_CMD_PROP_RADIO_DIV_SETUP_t));
+                return RF_pProp_lrm;
+            }
+            break;
+        case EasyLink_Phy_2_4_200kbps2gfsk:
+            if (cc2650)
+            {
+                memcpy(&pSetup->setup, RF_pCmdPropRadioSetup_2_4G_fsk, sizeof(rfc_CMD_PROP_RADIO_SETUP_t));
+                return RF_pProp_2_4G_fsk;
+            }
+            break;
+        default:
+            break;
+    }
+    return NULL;
+}
+
+//Sets the frequency of an FS command
+static void setFsFrequency(rfc_CMD_FS_t *pFs, uint32_t ui32Freq)
+{
+    pFs->frequency = (uint16_t)(ui32Freq / 1000000);
+    pFs->fractFreq = (uint16_t) (((uint64_t)ui32Freq -
+            ((uint64_t)pFs->frequency * 1000000)) * 65536 / 1000000);
+}
+
+//Computes the FS command of every channel from the FS command of the Phy
+static void buildChannelPlan(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < numChannels; i++)
+    {
+        channelFs[i] = EasyLink_cmdFs;
+        setFsFrequency(&channelFs[i], channelFreqs[i]);
+    }
+}
+
+//Forgets the ACK loss of all channels and clears the blacklist
+static void resetChannelStats(void)
+{
+    memset(channelLoss, 0, sizeof(channelLoss));
+    memset(channelResults, 0, sizeof(channelResults));
+    memset(channelProbation, 0, sizeof(channelProbation));
+    channelBlacklist = 0;
+}
+
+//Number of channels of the plan outside the blacklist
+static uint8_t countHopChannels(uint32_t blacklist)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    for (i = 0; i < numChannels; i++)
+    {
+        if (!(blacklist & (1UL << i)))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+//True when no Async command is queued or running
+static bool asyncIdle(void)
+{
+    uint8_t i;
+
+    if (EasyLink_CmdHandle_isValid(asyncCmdHndl))
+    {
+        return false;
+    }
+    for (i = 0; i < EASYLINK_NUM_TX_CMDS; i++)
+    {
+        if (txCmdPool[i].inUse)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//Takes the busyMutex for an operation that needs the radio to itself, which
+//fails while Async commands are queued
+static bool takeBusyMutex(void)
+{
+    if (Semaphore_pend(busyMutex, 0) == FALSE)
+    {
+        return false;
+    }
+    if (!asyncIdle())
+    {
+        Semaphore_post(busyMutex);
+        return false;
+    }
+    return true;
+}
+
+//Takes a free Async Tx command and loads the Tx command settings into it,
+//must be called with the busyMutex
+static TxCmdDesc* allocTxCmd(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < EASYLINK_NUM_TX_CMDS; i++)
+    {
+        if (!txCmdPool[i].inUse)
+        {
+            txCmdPool[i].queued = !asyncIdle();
+            txCmdPool[i].inUse = true;
+            txCmdPool[i].cmdHndl = EASYLINK_RF_CMD_HANDLE_INVALID;
+            txCmdPool[i].cmd = EasyLink_cmdPropTx;
+            return &txCmdPool[i];
+        }
+    }
+    return NULL;
+}
+
+//Finds the Async Tx command an RF driver callback is for
+static TxCmdDesc* findTxCmd(RF_CmdHandle ch)
+{
+    uint8_t i;
+
+    for (i = 0; i < EASYLINK_NUM_TX_CMDS; i++)
+    {
+        if (txCmdPool[i].inUse && (txCmdPool[i].cmdHndl == ch))
+        {
+            return &txCmdPool[i];
+        }
+    }
+    return NULL;
+}
+
+//Posts an Async command. Swis are held off so the handle is stored before
+//the callback, which runs in a Swi, can look for it
+static RF_CmdHandle postAsyncCmd(RF_Op *pOp, RF_Callback cb, RF_CmdHandle *pCmdHndl)
+{
+    UInt key = Swi_disable();
+
+    *pCmdHndl = RF_postCmd(rfHandle, pOp, RF_PriorityNormal, cb, EASYLINK_RF_EVENT_MASK);
+
+    Swi_restore(key);
+
+    return *pCmdHndl;
+}
+
+//Applies the inactivity timeout of the Tx or Rx about to be posted
+static void applyIdleTimeout(void)
+{
+    uint32_t timeout = rfParams.nInactivityTimeout;
+
+    if (nextIdleTimeout != EASYLINK_IDLE_TIMEOUT_NONE)
+    {
+        timeout = nextIdleTimeout;
+        nextIdleTimeout = EASYLINK_IDLE_TIMEOUT_NONE;
+    }
+    if (timeout != appliedIdleTimeout)
+    {
+        RF_control(rfHandle, RF_CTRL_SET_INACTIVITY_TIMEOUT, &timeout);
+        appliedIdleTimeout = timeout;
+    }
+}
+
+//Time a command posted now starts, absTime if it is scheduled later
+static uint64_t cmdSubmitTime(uint32_t absTime)
+{
+    uint64_t now = EasyLink_getAbsTime64();
+
+    if ( (absTime != 0) && ((int32_t)(absTime - (uint32_t)now) > 0) )
+    {
+        return now + (uint32_t)(absTime - (uint32_t)now);
+    }
+    return now;
+}
+
+//Air time of a Tx in radio time, from the symbol rate of the Phy
+static uint32_t txAirTime(uint16_t pktLen)
+{
+    //Preamble, sync word, length byte, address and payload, and CRC
+    uint32_t bits = 8 * (EasyLink_cmdPropRadioSetup.setup.preamConf.nPreamBytes + 1 + pktLen + 2) +
+            EasyLink_cmdPropRadioSetup.setup.formatConf.nSwBits;
+    uint32_t rateWord = EasyLink_cmdPropRadioSetup.setup.symbolRate.rateWord;
+
+    if (rateWord == 0)
+    {
+        return 0;
+    }
+
+    //Symbol rate is 24 MHz * rateWord / (2^20 * preScale), in a 4 MHz radio time
+    return (uint32_t)(((uint64_t)bits * EasyLink_cmdPropRadioSetup.setup.symbolRate.preScale << 20) /
+            ((uint64_t)rateWord * 6));
+}
+
+//Adds a finished Tx or Rx to the radio time statistics. txTime is the Tx
+//share of the command, the rest is Rx. The time since the previous command
+//counts as idle up to the inactivity timeout, after which the RF driver
+//powered the radio down
+static void accountRadioTime(uint64_t start, uint64_t end, bool queued, uint32_t txTime)
+{
+    uint64_t gap;
+    uint64_t active;
+    UInt key = Hwi_disable();
+
+    if (!lastCmdEndValid)
+    {
+        radioStats.nPowerUps++;
+    }
+    else if (queued)
+    {
+        //It started when the command ahead of it ended
+        start = lastCmdEndTime;
+    }
+    else
+    {
+        gap = start - lastCmdEndTime;
+        if (EasyLink_RadioTime_To_us(gap) > lastCmdIdleTimeout)
+        {
+            radioStats.idleTimeUs += lastCmdIdleTimeout;
+            radioStats.nPowerUps++;
+        }
+        else
+        {
+            radioStats.idleTimeUs += EasyLink_RadioTime_To_us(gap);
+        }
+    }
+
+    active = (end > start) ? (end - start) : 0;
+    if (txTime > active)
+    {
+        txTime = active;
+    }
+    radioStats.txTimeUs += EasyLink_RadioTime_To_us(txTime);
+    radioStats.rxTimeUs += EasyLink_RadioTime_To_us(active - txTime);
+
+    lastCmdEndTime = end;
+    lastCmdIdleTimeout = appliedIdleTimeout;
+    lastCmdEndValid = true;
+
+    Hwi_restore(key);
+}
+
+//Resets the Rx data entry and statistics before the Rx command is posted
+static void resetRxQueue(void)
+{
+    rfc_dataEntryGeneral_t *pDataEntry = (rfc_dataEntryGeneral_t*) rxBuffer;
+
+    //data entry rx buffer includes hdr (len-1Byte), addr (max 8Bytes) and data
+    pDataEntry->length = 1 + EASYLINK_MAX_ADDR_SIZE + EASYLINK_MAX_DATA_LENGTH;
+    pDataEntry->status = 0;
+    dataQueue.pCurrEntry = (uint8_t*) pDataEntry;
+    dataQueue.pLastEntry = NULL;
+    EasyLink_cmdPropRxAdv.pQueue = &dataQueue;               /* Set the Data Entity queue for received data */
+    EasyLink_cmdPropRxAdv.pOutput = (uint8_t*)&rxStatistics;
+
+    //Clear the Rx statistics structure
+    memset(&rxStatistics, 0, sizeof(rfc_propRxOutput_t));
+
+    //Stays like this if a chain stops before the Rx
+    EasyLink_cmdPropRxAdv.status = IDLE;
+}
+
+//Adds the outcome of a finished Rx command to radioStats and delivers the
+//receive events. Must be called before rxStatistics is cleared again
+static void accumulateRxStats(void)
+{
+    UInt key = Hwi_disable();
+
+    radioStats.nRxOk += rxStatistics.nRxOk;
+    radioStats.nRxNok += rxStatistics.nRxNok;
+    radioStats.nRxIgnored += rxStatistics.nRxIgnored;
+    radioStats.nRxStopped += rxStatistics.nRxStopped;
+    radioStats.nRxBufFull += rxStatistics.nRxBufFull;
+    if (EasyLink_cmdPropRxAdv.status == PROP_DONE_RXTIMEOUT)
+    {
+        radioStats.nRxTimeout++;
+    }
+    if ( (rxStatistics.nRxOk + rxStatistics.nRxNok + rxStatistics.nRxIgnored) != 0 )
+    {
+        radioStats.lastRssi = rxStatistics.lastRssi;
+        radioStats.lastTimeStamp = rxStatistics.timeStamp;
+    }
+
+    Hwi_restore(key);
+
+    if (rxEventCb != NULL)
+    {
+        if ( (rxStatistics.nRxNok != 0) && (rxEventMask & EasyLink_RxEvent_CrcError) )
+        {
+            rxEventCb(EasyLink_RxEvent_CrcError, rxStatistics.lastRssi, rxStatistics.timeStamp);
+        }
+        if ( (rxStatistics.nRxStopped != 0) && (rxEventMask & EasyLink_RxEvent_SyncOnly) )
+        {
+            rxEventCb(EasyLink_RxEvent_SyncOnly, rxStatistics.lastRssi, rxStatistics.timeStamp);
+        }
+    }
+}
+
+//Counts the outcome of a Tx command
+static void accumulateTxStats(bool ok)
+{
+    UInt key = Hwi_disable();
+
+    if (ok)
+    {
+        radioStats.nTxOk++;
+    }
+    else
+    {
+        radioStats.nTxError++;
+    }
+
+    Hwi_restore(key);
+}
+
+//Looks an address up in the software address filter
+static bool swAddrFilterMatch(const uint8_t *addr)
+{
+    int16_t low = 0;
+    int16_t high = (int16_t)swAddrNum - 1;
+    int16_t mid;
+    int cmp;
+
+    if (addrSize == 1)
+    {
+        return (swAddrBitmap[addr[0] >> 3] & (1 << (addr[0] & 0x07))) != 0;
+    }
+
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        cmp = memcmp(addr, &swAddrTable[mid * addrSize], addrSize);
+        if (cmp == 0)
+        {
+            return true;
+        }
+        else if (cmp < 0)
+        {
+            high = mid - 1;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+    return false;
+}
+
+//Checks a finished Rx against the software address filter. Only packets the
+//RF core filter did not match are looked up, before any of it is copied
+static bool swAddrFilterRejects(void)
+{
+    rfc_dataEntryGeneral_t *pDataEntry = (rfc_dataEntryGeneral_t*) rxBuffer;
+
+    return swAddrFilterEnabled &&
+           (EasyLink_cmdPropRxAdv.status == PROP_DONE_OK) &&
+           (pDataEntry->status == DATA_ENTRY_FINISHED) &&
+           (rxStatistics.nRxIgnored == 1) &&
+           !swAddrFilterMatch(&pDataEntry->data + 1);
+}
+
+//Sets up the Rx command to receive again after a packet was rejected
+static void restartRxCmd(void)
+{
+    EasyLink_cmdPropRxAdv.startTrigger.triggerType = TRIG_NOW;
+    EasyLink_cmdPropRxAdv.startTrigger.pastTrig = 1;
+    EasyLink_cmdPropRxAdv.startTime = 0;
+
+    //A timeout relative to the start would start over on every restart, count
+    //it from the rejected packet once instead
+    if (EasyLink_cmdPropRxAdv.endTrigger.triggerType == TRIG_REL_START)
+    {
+        EasyLink_cmdPropRxAdv.endTrigger.triggerType = TRIG_ABSTIME;
+        EasyLink_cmdPropRxAdv.endTime += rxStatistics.timeStamp;
+    }
+
+    resetRxQueue();
+}
+
 //Callback for Async Tx complete
 static void txDoneCallback(RF_Handle h, RF_CmdHandle ch, RF_EventMask e)
 {
     EasyLink_Status status;
+    EasyLink_TxDoneCb cb;
+    TxCmdDesc *pDesc = findTxCmd(ch);
 
-    //Release now so user callback can call EasyLink API's
-    Semaphore_post(busyMutex);
-    asyncCmdHndl = EASYLINK_RF_CMD_HANDLE_INVALID;
+    if (pDesc == NULL)
+    {
+        return;
+    }
+
+    accountRadioTime(pDesc->submitTime, EasyLink_getAbsTime64(), pDesc->queued,
+            EASYLINK_RADIO_TIME_ALL_TX);
+
+    //Free the command now so user callback can queue another one
+    cb = pDesc->cb;
+    pDesc->cmdHndl = EASYLINK_RF_CMD_HANDLE_INVALID;
+    pDesc->inUse = false;
+
+    accumulateTxStats((e & RF_EventLastCmdDone) != 0);
 
     if (e & RF_EventLastCmdDone)
     {
@@ -163,9 +672,9 @@ static void txDoneCallback(RF_Handle h, RF_CmdHandle ch, RF_EventMask e)
         status = EasyLink_Status_Tx_Error;
     }
 
-    if (txCb != NULL)
+    if (cb != NULL)
     {
-        txCb(status);
+        cb(status);
     }
 }
 
@@ -177,13 +686,47 @@ static void rxDoneCallback(RF_Handle h, RF_CmdHandle ch, RF_EventMask e)
     //allocated from the stack
     static EasyLink_RxPacket rxPacket;
     rfc_dataEntryGeneral_t *pDataEntry;
+    bool rejected = false;
+    bool txFailed = false;
     pDataEntry = (rfc_dataEntryGeneral_t*) rxBuffer;
 
-    //Release now so user callback can call EasyLink API's
-    Semaphore_post(busyMutex);
+    //The Tx of a chain is only counted once, not again after an Rx restart
+    if (pChainedTx != NULL)
+    {
+        txFailed = (pChainedTx->cmd.status != PROP_DONE_OK);
+        accumulateTxStats(!txFailed);
+        pChainedTx->inUse = false;
+        pChainedTx = NULL;
+    }
+    accumulateRxStats();
+
+    //Drop a packet for another address and keep receiving, like the RF core filter does
+    if ( (e & RF_EventLastCmdDone) && swAddrFilterRejects() )
+    {
+        restartRxCmd();
+        if (EasyLink_CmdHandle_isValid(postAsyncCmd((RF_Op*)&EasyLink_cmdPropRxAdv,
+                rxDoneCallback, &asyncCmdHndl)))
+        {
+            return;
+        }
+        rejected = true;
+    }
+
+    accountRadioTime(rxSubmitTime, EasyLink_getAbsTime64(), rxQueued, rxTxTime);
+
+    //Free the Rx now so user callback can call EasyLink API's
     asyncCmdHndl = EASYLINK_RF_CMD_HANDLE_INVALID;
 
-    if (e & RF_EventLastCmdDone)
+    if (rejected)
+    {
+        status = EasyLink_Status_Rx_Error;
+    }
+    else if ( (e & RF_EventLastCmdDone) && txFailed )
+    {
+        //The Tx failed, which stopped the chain before the Rx
+        status = EasyLink_Status_Tx_Error;
+    }
+    else if (e & RF_EventLastCmdDone)
     {
         //Check command status
         if (EasyLink_cmdPropRxAdv.status == PROP_DONE_OK)
@@ -266,7 +809,7 @@ static EasyLink_Status enableTestMode(EasyLink_CtrlOption mode)
         return EasyLink_Status_Param_Error;
     }
     //Check and take the busyMutex
-    if ( (Semaphore_pend(busyMutex, 0) == FALSE) || (EasyLink_CmdHandle_isValid(asyncCmdHndl)) )
+    if (!takeBusyMutex())
     {
         return EasyLink_Status_Busy_Error;
     }
@@ -323,10 +866,13 @@ static EasyLink_Status enableTestMode(EasyLink_CtrlOption mode)
 
 EasyLink_Status EasyLink_init(EasyLink_PhyType ui32ModType)
 {
+    const RF_Mode *pPhyMode;
+    uint8_t phy;
+
     if (configured)
     {
         //Already configure, check and take the busyMutex
-        if (Semaphore_pend(busyMutex, 0) == FALSE)
+        if (!takeBusyMutex())
         {
             return EasyLink_Status_Busy_Error;
         }
@@ -336,63 +882,43 @@ EasyLink_Status EasyLink_init(EasyLink_PhyType ui32ModType)
     if (!rfParamsConfigured)
     {
         RF_Params_init(&rfParams);
-        //set default InactivityTimeout to 1000us
-        rfParams.nInactivityTimeout = EasyLink_ms_To_RadioTime(1);
+        //set default InactivityTimeout to 1000us, the RF driver takes it in us
+        rfParams.nInactivityTimeout = 1000;
         rfParamsConfigured = 1;
     }
 
-    if (ui32ModType == EasyLink_Phy_Custom)
+    pPhyMode = getPhySettings(ui32ModType, &EasyLink_cmdPropRadioSetup);
+    if (pPhyMode == NULL)
     {
-        if(ChipInfo_GetChipType() == CHIP_TYPE_CC2650)
-        {
-            memcpy(&EasyLink_cmdPropRadioSetup.setup, &RF_cmdPropRadioDivSetup, sizeof(rfc_CMD_PROP_RADIO_SETUP_t));
-        }
-        else
+        if (busyMutex != NULL)
         {
-            memcpy(&EasyLink_cmdPropRadioSetup.divSetup, &RF_cmdPropRadioDivSetup, sizeof(rfc_CMD_PROP_RADIO_DIV_SETUP_t));
+            Semaphore_post(busyMutex);
         }
-        memcpy(&EasyLink_cmdFs, &RF_cmdFs, sizeof(rfc_CMD_FS_t));
-        memcpy(&EasyLink_RF_prop, &RF_prop, sizeof(RF_Mode));
-        memcpy(&EasyLink_cmdPropRxAdv, RF_pCmdPropRxAdv_preDef, sizeof(rfc_CMD_PROP_RX_ADV_t));
-        memcpy(&EasyLink_cmdPropTx, &RF_cmdPropTx, sizeof(rfc_CMD_PROP_TX_t));
-    }
-    else if ( (ui32ModType == EasyLink_Phy_50kbps2gfsk) && (ChipInfo_GetChipType() != CHIP_TYPE_CC2650) )
-    {
-        memcpy(&EasyLink_cmdPropRadioSetup.divSetup,
-                RF_pCmdPropRadioDivSetup_fsk,
-                sizeof(rfc_CMD_PROP_RADIO_DIV_SETUP_t));
-        memcpy(&EasyLink_cmdFs, RF_pCmdFs_preDef, sizeof(rfc_CMD_FS_t));
-        memcpy(&EasyLink_RF_prop, RF_pProp_fsk, sizeof(RF_Mode));
-        memcpy(&EasyLink_cmdPropRxAdv, RF_pCmdPropRxAdv_preDef, sizeof(rfc_CMD_PROP_RX_ADV_t));
-        memcpy(&EasyLink_cmdPropTx, RF_pCmdPropTx_preDef, sizeof(rfc_CMD_PROP_TX_t));
+        return EasyLink_Status_Param_Error;
     }
-    else if ( (ui32ModType == EasyLink_Phy_625bpsLrm) && (ChipInfo_GetChipType() != CHIP_TYPE_CC2650) )
+    memcpy(&EasyLink_RF_prop, pPhyMode, sizeof(RF_Mode));
+    memcpy(&EasyLink_cmdPropRxAdv, RF_pCmdPropRxAdv_preDef, sizeof(rfc_CMD_PROP_RX_ADV_t));
+    if (ui32ModType == EasyLink_Phy_Custom)
     {
-        memcpy(&EasyLink_cmdPropRadioSetup.divSetup,
-                RF_pCmdPropRadioDivSetup_lrm,
-                sizeof(rfc_CMD_PROP_RADIO_DIV_SETUP_t));
-        memcpy(&EasyLink_cmdFs, RF_pCmdFs_preDef, sizeof(rfc_CMD_FS_t));
-        memcpy(&EasyLink_RF_prop, RF_pProp_lrm, sizeof(RF_Mode));
-        memcpy(&EasyLink_cmdPropRxAdv, RF_pCmdPropRxAdv_preDef, sizeof(rfc_CMD_PROP_RX_ADV_t));
-        memcpy(&EasyLink_cmdPropTx, RF_pCmdPropTx_preDef, sizeof(rfc_CMD_PROP_TX_t));
+        memcpy(&EasyLink_cmdFs, &RF_cmdFs, sizeof(rfc_CMD_FS_t));
+        memcpy(&EasyLink_cmdPropTx, &RF_cmdPropTx, sizeof(rfc_CMD_PROP_TX_t));
     }
-    else if ( (ui32ModType == EasyLink_Phy_2_4_200kbps2gfsk) && (ChipInfo_GetChipType() == CHIP_TYPE_CC2650) )
+    else
     {
-        memcpy(&EasyLink_cmdPropRadioSetup.setup,
-                RF_pCmdPropRadioSetup_2_4G_fsk,
-                sizeof(rfc_CMD_PROP_RADIO_SETUP_t));
         memcpy(&EasyLink_cmdFs, RF_pCmdFs_preDef, sizeof(rfc_CMD_FS_t));
-        memcpy(&EasyLink_RF_prop, RF_pProp_2_4G_fsk, sizeof(RF_Mode));
-        memcpy(&EasyLink_cmdPropRxAdv, RF_pCmdPropRxAdv_preDef, sizeof(rfc_CMD_PROP_RX_ADV_t));
         memcpy(&EasyLink_cmdPropTx, RF_pCmdPropTx_preDef, sizeof(rfc_CMD_PROP_TX_t));
     }
-    else
+
+    //Cache the setup of every Phy that can be switched to without reopening
+    for (phy = 0; phy < EASYLINK_NUM_PHYS; phy++)
     {
-        if (busyMutex != NULL)
-        {
-            Semaphore_post(busyMutex);
-        }
-        return EasyLink_Status_Param_Error;
+        pPhyMode = getPhySettings((EasyLink_PhyType)phy, &phyCache[phy]);
+        //Field by field, a memcmp would also compare the padding after rfMode
+        phyCacheValid[phy] = (pPhyMode != NULL) &&
+                (pPhyMode->rfMode == EasyLink_RF_prop.rfMode) &&
+                (pPhyMode->cpePatchFxn == EasyLink_RF_prop.cpePatchFxn) &&
+                (pPhyMode->mcePatchFxn == EasyLink_RF_prop.mcePatchFxn) &&
+                (pPhyMode->rfePatchFxn == EasyLink_RF_prop.rfePatchFxn);
     }
 
     if (rfModeMultiClient)
@@ -403,6 +929,9 @@ EasyLink_Status EasyLink_init(EasyLink_PhyType ui32ModType)
     /* Request access to the radio */
     rfHandle = RF_open(&rfObject, &EasyLink_RF_prop,
             (RF_RadioSetup*)&EasyLink_cmdPropRadioSetup.setup, &rfParams);
+    appliedIdleTimeout = rfParams.nInactivityTimeout;
+    nextIdleTimeout = EASYLINK_IDLE_TIMEOUT_NONE;
+    lastCmdEndValid = false;
 
     //Set Rx packet size, taking into account addr which is not in the hdr
     //(only length can be)
@@ -421,6 +950,10 @@ EasyLink_Status EasyLink_init(EasyLink_PhyType ui32ModType)
     //Set the frequency
     RF_runCmd(rfHandle, (RF_Op*)&EasyLink_cmdFs, RF_PriorityNormal, 0, //asyncCmdCallback,
             EASYLINK_RF_EVENT_MASK);
+    pCurrentFs = &EasyLink_cmdFs;
+
+    //The channel plan is computed from the FS command of this Phy
+    buildChannelPlan();
 
     //set default asyncRxTimeOut to 0
     asyncRxTimeOut = 0;
@@ -465,15 +998,13 @@ EasyLink_Status EasyLink_setFrequency(uint32_t ui32Freq)
         return EasyLink_Status_Config_Error;
     }
     //Check and take the busyMutex
-    if (Semaphore_pend(busyMutex, 0) == FALSE)
+    if (!takeBusyMutex())
     {
         return EasyLink_Status_Busy_Error;
     }
 
     /* Set the frequency */
-    EasyLink_cmdFs.frequency = (uint16_t)(ui32Freq / 1000000);
-    EasyLink_cmdFs.fractFreq = (uint16_t) (((uint64_t)ui32Freq -
-            ((uint64_t)EasyLink_cmdFs.frequency * 1000000)) * 65536 / 1000000);
+    setFsFrequency(&EasyLink_cmdFs, ui32Freq);
 
     /* Run command */
     RF_EventMask result = RF_runCmd(rfHandle, (RF_Op*)&EasyLink_cmdFs,
@@ -483,6 +1014,7 @@ EasyLink_Status EasyLink_setFrequency(uint32_t ui32Freq)
     {
         status = EasyLink_Status_Success;
     }
+    pCurrentFs = &EasyLink_cmdFs;
 
     Semaphore_post(busyMutex);
 
@@ -498,25 +1030,313 @@ uint32_t EasyLink_getFrequency(void)
         return EasyLink_Status_Config_Error;
     }
 
-    freq_khz = EasyLink_cmdFs.frequency * 1000000;
-    freq_khz += ((((uint64_t)EasyLink_cmdFs.fractFreq * 1000000)) / 65536);
+    freq_khz = pCurrentFs->frequency * 1000000;
+    freq_khz += ((((uint64_t)pCurrentFs->fractFreq * 1000000)) / 65536);
 
     return freq_khz;
 }
 
-EasyLink_Status EasyLink_setRfPwr(int8_t i8txPowerdBm)
+EasyLink_Status EasyLink_setChannelPlan(const uint32_t *pui32Freqs, uint8_t ui8NumChannels)
 {
-    EasyLink_Status status = EasyLink_Status_Cmd_Error;
-    rfc_CMD_SCH_IMM_t immOpCmd = {0};
-    rfc_CMD_SET_TX_POWER_t cmdSetPower = {0};
-    uint8_t txPowerIdx;
-
+    if ( (pui32Freqs == NULL) || (ui8NumChannels > EASYLINK_MAX_CHANNELS) )
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex, the cached commands may be in use
+    if ( configured && (!takeBusyMutex()) )
+    {
+        return EasyLink_Status_Busy_Error;
+    }
+
+    memcpy(channelFreqs, pui32Freqs, ui8NumChannels * sizeof(uint32_t));
+    numChannels = ui8NumChannels;
+    //Channel indexes now refer to other frequencies
+    resetChannelStats();
+    if (pCurrentFs != &EasyLink_cmdFs)
+    {
+        //The cached command being used is about to change
+        EasyLink_cmdFs = *pCurrentFs;
+        pCurrentFs = &EasyLink_cmdFs;
+    }
+    if (configured)
+    {
+        buildChannelPlan();
+        Semaphore_post(busyMutex);
+    }
+
+    return EasyLink_Status_Success;
+}
+
+EasyLink_Status EasyLink_setChannel(uint8_t ui8Channel)
+{
+    EasyLink_Status status = EasyLink_Status_Cmd_Error;
+
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
+    if (ui8Channel >= numChannels)
+    {
+        return EasyLink_Status_Param_Error;
+    }
     //Check and take the busyMutex
-    if (Semaphore_pend(busyMutex, 0) == FALSE)
+    if (!takeBusyMutex())
+    {
+        return EasyLink_Status_Busy_Error;
+    }
+
+    /* Run the cached command */
+    RF_EventMask result = RF_runCmd(rfHandle, (RF_Op*)&channelFs[ui8Channel],
+            RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
+
+    if (result & RF_EventLastCmdDone)
+    {
+        status = EasyLink_Status_Success;
+    }
+    pCurrentFs = &channelFs[ui8Channel];
+
+    Semaphore_post(busyMutex);
+
+    return status;
+}
+
+EasyLink_Status EasyLink_setPhy(EasyLink_PhyType ui32ModType)
+{
+    EasyLink_Status status = EasyLink_Status_Cmd_Error;
+    uint16_t txPower;
+
+    if ( (!configured) || suspended)
+    {
+        return EasyLink_Status_Config_Error;
+    }
+    if ( ((uint32_t)ui32ModType >= EASYLINK_NUM_PHYS) || (!phyCacheValid[ui32ModType]) )
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex
+    if (!takeBusyMutex())
+    {
+        return EasyLink_Status_Busy_Error;
+    }
+
+    //The RF driver runs the setup command it was opened with on every power
+    //up, so the cached image is swapped into it rather than pointed to. The
+    //Tx power set with EasyLink_setRfPwr is kept over the cached default.
+    txPower = EasyLink_cmdPropRadioSetup.setup.txPower;
+    EasyLink_cmdPropRadioSetup = phyCache[ui32ModType];
+    EasyLink_cmdPropRadioSetup.setup.txPower = txPower;
+
+    RF_EventMask result = RF_runCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropRadioSetup,
+            RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
+
+    //The synthesizer has to be programmed again after a setup
+    if (result & RF_EventLastCmdDone)
+    {
+        result = RF_runCmd(rfHandle, (RF_Op*)pCurrentFs,
+                RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
+    }
+
+    if (result & RF_EventLastCmdDone)
+    {
+        status = EasyLink_Status_Success;
+    }
+
+    Semaphore_post(busyMutex);
+
+    return status;
+}
+
+EasyLink_Status EasyLink_enableHopping(uint32_t ui32Seed)
+{
+    if ( (!configured) || suspended)
+    {
+        return EasyLink_Status_Config_Error;
+    }
+    if (numChannels == 0)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+
+    hopSeed = ui32Seed;
+    hoppingEnabled = true;
+
+    return EasyLink_Status_Success;
+}
+
+void EasyLink_disableHopping(void)
+{
+    hoppingEnabled = false;
+}
+
+uint8_t EasyLink_getHopChannel(uint32_t ui32Slot)
+{
+    uint32_t x;
+    uint8_t n;
+    uint8_t i;
+
+    if (numChannels == 0)
+    {
+        return 0;
+    }
+
+    //Hash the slot number, a finalizer with good avalanche keeps neighbouring
+    //slots on unrelated channels
+    x = (ui32Slot * 0x9E3779B9) ^ hopSeed;
+    x ^= x >> 16;
+    x *= 0x85EBCA6B;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35;
+    x ^= x >> 16;
+
+    //Pick among the channels outside the blacklist
+    n = x % countHopChannels(channelBlacklist);
+    for (i = 0; i < numChannels; i++)
+    {
+        if (!(channelBlacklist & (1UL << i)))
+        {
+            if (n == 0)
+            {
+                break;
+            }
+            n--;
+        }
+    }
+
+    return i;
+}
+
+static void hopDoneCallback(RF_Handle h, RF_CmdHandle ch, RF_EventMask e)
+{
+    hopPending = false;
+}
+
+EasyLink_Status EasyLink_scheduleHop(uint32_t ui32Slot, uint32_t ui32AbsTime)
+{
+    RF_CmdHandle cmdHndl;
+    uint8_t channel;
+    UInt key;
+
+    if ( (!configured) || suspended)
+    {
+        return EasyLink_Status_Config_Error;
+    }
+    if (!hoppingEnabled)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+
+    //The busyMutex is not taken, the FS only uses its own copy of the command
+    //and the RF driver queues it behind whatever command is running
+    key = Hwi_disable();
+    if (hopPending)
+    {
+        Hwi_restore(key);
+        return EasyLink_Status_Busy_Error;
+    }
+    hopPending = true;
+    Hwi_restore(key);
+
+    channel = EasyLink_getHopChannel(ui32Slot);
+    hopFs = channelFs[channel];
+    hopFs.startTrigger.triggerType = TRIG_ABSTIME;
+    hopFs.startTrigger.pastTrig = 1;
+    hopFs.startTime = ui32AbsTime;
+
+    cmdHndl = RF_postCmd(rfHandle, (RF_Op*)&hopFs, RF_PriorityNormal,
+            hopDoneCallback, EASYLINK_RF_EVENT_MASK);
+    if (!EasyLink_CmdHandle_isValid(cmdHndl))
+    {
+        hopPending = false;
+        return EasyLink_Status_Cmd_Error;
+    }
+    pCurrentFs = &channelFs[channel];
+
+    return EasyLink_Status_Success;
+}
+
+void EasyLink_reportChannelResult(uint8_t ui8Channel, bool bAcked)
+{
+    int16_t sample = bAcked ? 0 : 255;
+    uint8_t i;
+
+    if (ui8Channel >= numChannels)
+    {
+        return;
+    }
+
+    //Blacklisted channels get no traffic, they are retried after a while
+    for (i = 0; i < numChannels; i++)
+    {
+        if ((channelBlacklist & (1UL << i)) && (--channelProbation[i] == 0))
+        {
+            channelBlacklist &= ~(1UL << i);
+            channelLoss[i] = EASYLINK_HOP_BLACKLIST_LOSS / 2;
+            channelResults[i] = 0;
+        }
+    }
+
+    channelLoss[ui8Channel] += (sample - channelLoss[ui8Channel]) >> EASYLINK_HOP_LOSS_SHIFT;
+    if (channelResults[ui8Channel] < EASYLINK_HOP_MIN_RESULTS)
+    {
+        channelResults[ui8Channel]++;
+    }
+
+    if ( (channelResults[ui8Channel] >= EASYLINK_HOP_MIN_RESULTS) &&
+         (channelLoss[ui8Channel] >= EASYLINK_HOP_BLACKLIST_LOSS) &&
+         (!(channelBlacklist & (1UL << ui8Channel))) &&
+         (countHopChannels(channelBlacklist) > EASYLINK_HOP_MIN_CHANNELS) )
+    {
+        channelBlacklist |= 1UL << ui8Channel;
+        channelProbation[ui8Channel] = EASYLINK_HOP_PROBATION_RESULTS;
+    }
+}
+
+uint32_t EasyLink_getChannelBlacklist(void)
+{
+    return channelBlacklist;
+}
+
+EasyLink_Status EasyLink_setChannelBlacklist(uint32_t ui32Blacklist)
+{
+    uint8_t i;
+
+    ui32Blacklist &= (numChannels >= 32) ? 0xFFFFFFFF : ((1UL << numChannels) - 1);
+    if ( (ui32Blacklist != 0) &&
+         (countHopChannels(ui32Blacklist) < EASYLINK_HOP_MIN_CHANNELS) )
+    {
+        return EasyLink_Status_Param_Error;
+    }
+
+    for (i = 0; i < numChannels; i++)
+    {
+        if ((ui32Blacklist & (1UL << i)) && !(channelBlacklist & (1UL << i)))
+        {
+            channelProbation[i] = EASYLINK_HOP_PROBATION_RESULTS;
+        }
+        else if (!(ui32Blacklist & (1UL << i)) && (channelBlacklist & (1UL << i)))
+        {
+            channelLoss[i] = EASYLINK_HOP_BLACKLIST_LOSS / 2;
+            channelResults[i] = 0;
+        }
+    }
+    channelBlacklist = ui32Blacklist;
+
+    return EasyLink_Status_Success;
+}
+
+EasyLink_Status EasyLink_setRfPwr(int8_t i8txPowerdBm)
+{
+    EasyLink_Status status = EasyLink_Status_Cmd_Error;
+    rfc_CMD_SCH_IMM_t immOpCmd = {0};
+    rfc_CMD_SET_TX_POWER_t cmdSetPower = {0};
+    uint8_t txPowerIdx;
+
+    if ( (!configured) || suspended)
+    {
+        return EasyLink_Status_Config_Error;
+    }
+    //Check and take the busyMutex
+    if (!takeBusyMutex())
     {
         return EasyLink_Status_Busy_Error;
     }
@@ -552,187 +1372,397 @@ EasyLink_Status EasyLink_setRfPwr(int8_t i8txPowerdBm)
             txPowerIdx < rfPowerTableSize;
             txPowerIdx++)
     {
-        if (i8txPowerdBm >= rfPowerTable[txPowerIdx].dbm)
-        {
-            cmdSetPower.txPower = rfPowerTable[txPowerIdx].txPower;
-            EasyLink_cmdPropRadioSetup.setup.txPower = rfPowerTable[txPowerIdx].txPower;
-        }
+        if (i8txPowerdBm >= rfPowerTable[txPowerIdx].dbm)
+        {
+            cmdSetPower.txPower = rfPowerTable[txPowerIdx].txPower;
+            EasyLink_cmdPropRadioSetup.setup.txPower = rfPowerTable[txPowerIdx].txPower;
+        }
+    }
+
+    //point the Operational Command to the immediate set power command
+    immOpCmd.cmdrVal = (uint32_t) &cmdSetPower;
+
+    // Send command
+    RF_CmdHandle cmd = RF_postCmd(rfHandle, (RF_Op*)&immOpCmd,
+            RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
+
+    RF_EventMask result = RF_pendCmd(rfHandle, cmd,  (RF_EventLastCmdDone |
+            RF_EventCmdError));
+
+    if (result & RF_EventLastCmdDone)
+    {
+        status = EasyLink_Status_Success;
+    }
+
+    //Release the busyMutex
+    Semaphore_post(busyMutex);
+
+    return status;
+}
+
+int8_t EasyLink_getRfPwr(void)
+{
+    uint8_t txPowerIdx;
+    int8_t txPowerdBm = 0xff;
+
+    if ( (!configured) || suspended)
+    {
+        return EasyLink_Status_Config_Error;
+    }
+
+    for (txPowerIdx = 0;
+            txPowerIdx < rfPowerTableSize;
+            txPowerIdx++)
+    {
+        if (rfPowerTable[txPowerIdx].txPower == EasyLink_cmdPropRadioSetup.setup.txPower)
+        {
+            txPowerdBm = rfPowerTable[txPowerIdx].dbm;
+            continue;
+        }
+    }
+
+    //if CCFG_FORCE_VDDR_HH is not set max power cannot be achieved
+#if (CCFG_FORCE_VDDR_HH != 0x1)
+    if (txPowerdBm == rfPowerTable[rfPowerTableSize-1].dbm)
+    {
+        txPowerdBm = rfPowerTable[rfPowerTableSize-2].dbm;
+    }
+#endif
+
+    return txPowerdBm;
+}
+
+uint32_t EasyLink_getAbsTime(void)
+{
+    if ( (!configured) || suspended)
+    {
+        return EasyLink_Status_Config_Error;
+    }
+
+    return (uint32_t)EasyLink_getAbsTime64();
+}
+
+uint64_t EasyLink_getAbsTime64(void)
+{
+    uint32_t now;
+    uint64_t rtc;
+    uint64_t rtcElapsed;
+    uint64_t expected;
+    uint64_t absTime;
+    UInt key = Hwi_disable();
+
+    now = RF_getCurrentTime();
+    rtc = AONRTCCurrent64BitValueGet();
+
+    if (!absTime64Valid)
+    {
+        absTime = now;
+        absTime64Valid = true;
+    }
+    else
+    {
+        //The RTC is 32.32 fixed point seconds, convert the time since the last
+        //call without overflowing
+        rtcElapsed = rtc - lastRtc;
+        expected = lastAbsTime64 + (rtcElapsed >> 32) * EASYLINK_RADIO_TIME_HZ +
+                (((rtcElapsed & 0xFFFFFFFF) * EASYLINK_RADIO_TIME_HZ) >> 32);
+
+        //Take the low 32 bits from the radio time, the RTC only tells how
+        //many times it wrapped, so its coarse resolution does not matter
+        absTime = expected + (int32_t)(now - (uint32_t)expected);
+        if (absTime < lastAbsTime64)
+        {
+            absTime = lastAbsTime64;
+        }
+    }
+    lastAbsTime64 = absTime;
+    lastRtc = rtc;
+
+    Hwi_restore(key);
+
+    return absTime;
+}
+
+uint64_t EasyLink_extendAbsTime(uint32_t ui32AbsTime)
+{
+    uint64_t now = EasyLink_getAbsTime64();
+
+    return now + (int32_t)(ui32AbsTime - (uint32_t)now);
+}
+
+//Points a Tx command at a packet that starts with the address
+static void setupTxCmd(rfc_CMD_PROP_TX_t *pCmd, uint8_t *pPkt, uint8_t len, uint32_t absTime)
+{
+    //packet length to Tx includes address
+    pCmd->pktLen = len + addrSize;
+    pCmd->pPkt = pPkt;
+
+    //Nothing runs after the Tx unless it is chained to an Rx
+    pCmd->pNextOp = NULL;
+    pCmd->condition.rule = COND_NEVER;
+
+    if (absTime != 0)
+    {
+        pCmd->startTrigger.triggerType = TRIG_ABSTIME;
+        pCmd->startTrigger.pastTrig = 1;
+        pCmd->startTime = absTime;
+    }
+    else
+    {
+        pCmd->startTrigger.triggerType = TRIG_NOW;
+        pCmd->startTrigger.pastTrig = 1;
+        pCmd->startTime = 0;
     }
+}
 
-    //point the Operational Command to the immediate set power command
-    immOpCmd.cmdrVal = (uint32_t) &cmdSetPower;
+//Writes the address into the headroom of a Tx buffer, returns the start of the packet
+static uint8_t* fillTxHeadroom(EasyLink_TxBuffer *txBuf)
+{
+    uint8_t *pPkt = &txBuf->headroom[EASYLINK_TX_HEADROOM_SIZE - addrSize];
 
-    // Send command
-    RF_CmdHandle cmd = RF_postCmd(rfHandle, (RF_Op*)&immOpCmd,
+    memcpy(pPkt, txBuf->dstAddr, addrSize);
+    return pPkt;
+}
+
+//Sends the packet set up in EasyLink_cmdPropTx and releases the busyMutex
+static EasyLink_Status runTxCmd(void)
+{
+    EasyLink_Status status = EasyLink_Status_Tx_Error;
+    uint64_t submitTime;
+
+    applyIdleTimeout();
+    submitTime = cmdSubmitTime(EasyLink_cmdPropTx.startTime);
+
+    // Send packet
+    RF_CmdHandle cmdHdl = RF_postCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropTx,
             RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
 
-    RF_EventMask result = RF_pendCmd(rfHandle, cmd,  (RF_EventLastCmdDone |
+    // Wait for Command to complete
+    RF_EventMask result = RF_pendCmd(rfHandle, cmdHdl,  (RF_EventLastCmdDone |
             RF_EventCmdError));
 
+    accountRadioTime(submitTime, EasyLink_getAbsTime64(), false, EASYLINK_RADIO_TIME_ALL_TX);
+
     if (result & RF_EventLastCmdDone)
     {
         status = EasyLink_Status_Success;
     }
+    accumulateTxStats(status == EasyLink_Status_Success);
 
     //Release the busyMutex
     Semaphore_post(busyMutex);
 
+
     return status;
 }
 
-int8_t EasyLink_getRfPwr(void)
+//Queues an Async Tx command and releases the busyMutex, the command is freed
+//by txDoneCallback
+static EasyLink_Status postTxCmd(TxCmdDesc *pDesc, EasyLink_TxDoneCb cb)
 {
-    uint8_t txPowerIdx;
-    int8_t txPowerdBm = 0xff;
+    EasyLink_Status status = EasyLink_Status_Tx_Error;
 
-    if ( (!configured) || suspended)
-    {
-        return EasyLink_Status_Config_Error;
-    }
+    //store application callback
+    pDesc->cb = cb;
 
-    for (txPowerIdx = 0;
-            txPowerIdx < rfPowerTableSize;
-            txPowerIdx++)
+    applyIdleTimeout();
+    pDesc->submitTime = cmdSubmitTime(pDesc->cmd.startTime);
+
+    /* Send packet */
+    if (EasyLink_CmdHandle_isValid(postAsyncCmd((RF_Op*)&pDesc->cmd,
+            txDoneCallback, &pDesc->cmdHndl)))
     {
-        if (rfPowerTable[txPowerIdx].txPower == EasyLink_cmdPropRadioSetup.setup.txPower)
-        {
-            txPowerdBm = rfPowerTable[txPowerIdx].dbm;
-            continue;
-        }
+        status = EasyLink_Status_Success;
     }
-
-    //if CCFG_FORCE_VDDR_HH is not set max power cannot be achieved
-#if (CCFG_FORCE_VDDR_HH != 0x1)
-    if (txPowerdBm == rfPowerTable[rfPowerTableSize-1].dbm)
+    else
     {
-        txPowerdBm = rfPowerTable[rfPowerTableSize-2].dbm;
+        pDesc->inUse = false;
     }
-#endif
 
-    return txPowerdBm;
+    Semaphore_post(busyMutex);
+
+    return status;
 }
 
-uint32_t EasyLink_getAbsTime(void)
+EasyLink_Status EasyLink_transmit(EasyLink_TxPacket *txPacket)
 {
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
+    if (txPacket->len > EASYLINK_MAX_DATA_LENGTH)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex
+    if (!takeBusyMutex())
+    {
+        return EasyLink_Status_Busy_Error;
+    }
 
-    return RF_getCurrentTime();
+    memcpy(txBuffer, txPacket->dstAddr, addrSize);
+    memcpy(txBuffer + addrSize, txPacket->payload, txPacket->len);
+    setupTxCmd(&EasyLink_cmdPropTx, txBuffer, txPacket->len, txPacket->absTime);
+
+    return runTxCmd();
 }
 
-EasyLink_Status EasyLink_transmit(EasyLink_TxPacket *txPacket)
+EasyLink_Status EasyLink_transmitAsync(EasyLink_TxPacket *txPacket, EasyLink_TxDoneCb cb)
 {
-    EasyLink_Status status = EasyLink_Status_Tx_Error;
+    TxCmdDesc *pDesc;
 
+    //Check if not configure or already an Async command being performed
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
-    //Check and take the busyMutex
+    if (txPacket->len > EASYLINK_MAX_DATA_LENGTH)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex, then a free Tx command
     if (Semaphore_pend(busyMutex, 0) == FALSE)
     {
         return EasyLink_Status_Busy_Error;
     }
-    if (txPacket->len > EASYLINK_MAX_DATA_LENGTH)
+    pDesc = allocTxCmd();
+    if (pDesc == NULL)
     {
-        return EasyLink_Status_Param_Error;
+        Semaphore_post(busyMutex);
+        return EasyLink_Status_Busy_Error;
     }
 
-    memcpy(txBuffer, txPacket->dstAddr, addrSize);
-    memcpy(txBuffer + addrSize, txPacket->payload, txPacket->len);
+    memcpy(pDesc->buffer, txPacket->dstAddr, addrSize);
+    memcpy(pDesc->buffer + addrSize, txPacket->payload, txPacket->len);
+    setupTxCmd(&pDesc->cmd, pDesc->buffer, txPacket->len, txPacket->absTime);
 
-    //packet length to Tx includes address
-    EasyLink_cmdPropTx.pktLen = txPacket->len + addrSize;
-    EasyLink_cmdPropTx.pPkt = txBuffer;
+    return postTxCmd(pDesc, cb);
+}
 
-    if (txPacket->absTime != 0)
+EasyLink_Status EasyLink_transmitBuffer(EasyLink_TxBuffer *txBuf)
+{
+    if ( (!configured) || suspended)
     {
-        EasyLink_cmdPropTx.startTrigger.triggerType = TRIG_ABSTIME;
-        EasyLink_cmdPropTx.startTrigger.pastTrig = 1;
-        EasyLink_cmdPropTx.startTime = txPacket->absTime;
+        return EasyLink_Status_Config_Error;
     }
-    else
+    if (txBuf->len > EASYLINK_MAX_DATA_LENGTH)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex
+    if (!takeBusyMutex())
     {
-        EasyLink_cmdPropTx.startTrigger.triggerType = TRIG_NOW;
-        EasyLink_cmdPropTx.startTrigger.pastTrig = 1;
-        EasyLink_cmdPropTx.startTime = 0;
+        return EasyLink_Status_Busy_Error;
     }
 
-    // Send packet
-    RF_CmdHandle cmdHdl = RF_postCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropTx,
-            RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
+    setupTxCmd(&EasyLink_cmdPropTx, fillTxHeadroom(txBuf), txBuf->len, txBuf->absTime);
 
-    // Wait for Command to complete
-    RF_EventMask result = RF_pendCmd(rfHandle, cmdHdl,  (RF_EventLastCmdDone |
-            RF_EventCmdError));
+    return runTxCmd();
+}
 
+EasyLink_Status EasyLink_transmitBufferAsync(EasyLink_TxBuffer *txBuf, EasyLink_TxDoneCb cb)
+{
+    TxCmdDesc *pDesc;
 
-    if (result & RF_EventLastCmdDone)
+    //Check if not configure or already an Async command being performed
+    if ( (!configured) || suspended)
     {
-        status = EasyLink_Status_Success;
+        return EasyLink_Status_Config_Error;
+    }
+    if (txBuf->len > EASYLINK_MAX_DATA_LENGTH)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex, then a free Tx command
+    if (Semaphore_pend(busyMutex, 0) == FALSE)
+    {
+        return EasyLink_Status_Busy_Error;
+    }
+    pDesc = allocTxCmd();
+    if (pDesc == NULL)
+    {
+        Semaphore_post(busyMutex);
+        return EasyLink_Status_Busy_Error;
     }
 
-    //Release the busyMutex
-    Semaphore_post(busyMutex);
-
+    setupTxCmd(&pDesc->cmd, fillTxHeadroom(txBuf), txBuf->len, txBuf->absTime);
 
-    return status;
+    return postTxCmd(pDesc, cb);
 }
 
-EasyLink_Status EasyLink_transmitAsync(EasyLink_TxPacket *txPacket, EasyLink_TxDoneCb cb)
+EasyLink_Status EasyLink_transmitBufferAndReceiveAsync(EasyLink_TxBuffer *txBuf,
+        uint32_t rxTimeout, EasyLink_ReceiveCb cb)
 {
     EasyLink_Status status = EasyLink_Status_Tx_Error;
+    TxCmdDesc *pDesc;
 
     //Check if not configure or already an Async command being performed
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
-    //Check and take the busyMutex
-    if ( (Semaphore_pend(busyMutex, 0) == FALSE) || (EasyLink_CmdHandle_isValid(asyncCmdHndl)) )
+    if (txBuf->len > EASYLINK_MAX_DATA_LENGTH)
+    {
+        return EasyLink_Status_Param_Error;
+    }
+    //Check and take the busyMutex, the Rx command and a free Tx command
+    if (Semaphore_pend(busyMutex, 0) == FALSE)
     {
         return EasyLink_Status_Busy_Error;
     }
-    if (txPacket->len > EASYLINK_MAX_DATA_LENGTH)
+    pDesc = EasyLink_CmdHandle_isValid(asyncCmdHndl) ? NULL : allocTxCmd();
+    if (pDesc == NULL)
     {
-        return EasyLink_Status_Param_Error;
+        Semaphore_post(busyMutex);
+        return EasyLink_Status_Busy_Error;
     }
 
-    //store application callback
-    txCb = cb;
+    rxCb = cb;
 
-    memcpy(txBuffer, txPacket->dstAddr, addrSize);
-    memcpy(txBuffer + addrSize, txPacket->payload, txPacket->len);
+    setupTxCmd(&pDesc->cmd, fillTxHeadroom(txBuf), txBuf->len, txBuf->absTime);
 
-    //packet length to Tx includes address
-    EasyLink_cmdPropTx.pktLen = txPacket->len + addrSize;
-    EasyLink_cmdPropTx.pPkt = txBuffer;
+    //The radio core starts the Rx as soon as the Tx is done
+    pDesc->cmd.pNextOp = (uint8_t*)&EasyLink_cmdPropRxAdv;
+    pDesc->cmd.condition.rule = COND_STOP_ON_FALSE;
 
-    if (txPacket->absTime != 0)
+    resetRxQueue();
+
+    EasyLink_cmdPropRxAdv.startTrigger.triggerType = TRIG_NOW;
+    EasyLink_cmdPropRxAdv.startTrigger.pastTrig = 1;
+    EasyLink_cmdPropRxAdv.startTime = 0;
+
+    //Time out relative to the start of the Rx, so the CPU does not have to be there
+    if (rxTimeout != 0)
     {
-        EasyLink_cmdPropTx.startTrigger.triggerType = TRIG_ABSTIME;
-        EasyLink_cmdPropTx.startTrigger.pastTrig = 1;
-        EasyLink_cmdPropTx.startTime = txPacket->absTime;
+        EasyLink_cmdPropRxAdv.endTrigger.triggerType = TRIG_REL_START;
+        EasyLink_cmdPropRxAdv.endTime = rxTimeout;
     }
     else
     {
-        EasyLink_cmdPropTx.startTrigger.triggerType = TRIG_NOW;
-        EasyLink_cmdPropTx.startTrigger.pastTrig = 1;
-        EasyLink_cmdPropTx.startTime = 0;
+        EasyLink_cmdPropRxAdv.endTrigger.triggerType = TRIG_NEVER;
+        EasyLink_cmdPropRxAdv.endTime = 0;
     }
 
-    /* Send packet */
-    asyncCmdHndl = RF_postCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropTx,
-            RF_PriorityNormal, txDoneCallback, EASYLINK_RF_EVENT_MASK);
+    applyIdleTimeout();
+    pDesc->submitTime = cmdSubmitTime(pDesc->cmd.startTime);
+    rxSubmitTime = pDesc->submitTime;
+    rxQueued = pDesc->queued;
+    rxTxTime = txAirTime(pDesc->cmd.pktLen);
 
-    if (EasyLink_CmdHandle_isValid(asyncCmdHndl))
+    //The chain completes through rxDoneCallback, which frees the Tx command
+    pChainedTx = pDesc;
+    if (EasyLink_CmdHandle_isValid(postAsyncCmd((RF_Op*)&pDesc->cmd,
+            rxDoneCallback, &asyncCmdHndl)))
     {
         status = EasyLink_Status_Success;
     }
+    else
+    {
+        pChainedTx = NULL;
+        pDesc->inUse = false;
+    }
 
-    //busyMutex will be released by the callback
+    Semaphore_post(busyMutex);
 
     return status;
 }
@@ -742,25 +1772,20 @@ EasyLink_Status EasyLink_receive(EasyLink_RxPacket *rxPacket)
     EasyLink_Status status = EasyLink_Status_Rx_Error;
     RF_EventMask result;
     rfc_dataEntryGeneral_t *pDataEntry;
+    uint64_t submitTime;
 
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
     //Check and take the busyMutex
-    if (Semaphore_pend(busyMutex, 0) == FALSE)
+    if (!takeBusyMutex())
     {
         return EasyLink_Status_Busy_Error;
     }
 
     pDataEntry = (rfc_dataEntryGeneral_t*) rxBuffer;
-    //data entry rx buffer includes hdr (len-1Byte), addr (max 8Bytes) and data
-    pDataEntry->length = 1 + EASYLINK_MAX_ADDR_SIZE + EASYLINK_MAX_DATA_LENGTH;
-    pDataEntry->status = 0;
-    dataQueue.pCurrEntry = (uint8_t*) pDataEntry;
-    dataQueue.pLastEntry = NULL;
-    EasyLink_cmdPropRxAdv.pQueue = &dataQueue;               /* Set the Data Entity queue for received data */
-    EasyLink_cmdPropRxAdv.pOutput = (uint8_t*)&rxStatistics;
+    resetRxQueue();
 
     if (rxPacket->absTime != 0)
     {
@@ -778,7 +1803,7 @@ EasyLink_Status EasyLink_receive(EasyLink_RxPacket *rxPacket)
     if (rxPacket->rxTimeout != 0)
     {
         EasyLink_cmdPropRxAdv.endTrigger.triggerType = TRIG_ABSTIME;
-        EasyLink_cmdPropRxAdv.endTime = RF_getCurrentTime() + rxPacket->rxTimeout;
+        EasyLink_cmdPropRxAdv.endTime = (uint32_t)EasyLink_getAbsTime64() + rxPacket->rxTimeout;
     }
     else
     {
@@ -786,14 +1811,26 @@ EasyLink_Status EasyLink_receive(EasyLink_RxPacket *rxPacket)
         EasyLink_cmdPropRxAdv.endTime = 0;
     }
 
-    //Clear the Rx statistics structure
-    memset(&rxStatistics, 0, sizeof(rfc_propRxOutput_t));
+    applyIdleTimeout();
+    submitTime = cmdSubmitTime(rxPacket->absTime);
 
-    RF_CmdHandle rx_cmd = RF_postCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropRxAdv,
-            RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
+    while (1)
+    {
+        RF_CmdHandle rx_cmd = RF_postCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropRxAdv,
+                RF_PriorityNormal, 0, EASYLINK_RF_EVENT_MASK);
 
-    /* Wait for Command to complete */
-    result = RF_pendCmd(rfHandle, rx_cmd, (RF_EventLastCmdDone | RF_EventCmdError));
+        /* Wait for Command to complete */
+        result = RF_pendCmd(rfHandle, rx_cmd, (RF_EventLastCmdDone | RF_EventCmdError));
+        accumulateRxStats();
+
+        //Drop a packet for another address and keep receiving
+        if ( !(result & RF_EventLastCmdDone) || !swAddrFilterRejects() )
+        {
+            break;
+        }
+        restartRxCmd();
+    }
+    accountRadioTime(submitTime, EasyLink_getAbsTime64(), false, EASYLINK_RADIO_TIME_ALL_RX);
 
     if (result & RF_EventLastCmdDone)
     {
@@ -854,29 +1891,26 @@ EasyLink_Status EasyLink_receive(EasyLink_RxPacket *rxPacket)
 EasyLink_Status EasyLink_receiveAsync(EasyLink_ReceiveCb cb, uint32_t absTime)
 {
     EasyLink_Status status = EasyLink_Status_Rx_Error;
-    rfc_dataEntryGeneral_t *pDataEntry;
 
     //Check if not configure of already an Async command being performed
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
-    //Check and take the busyMutex
-    if ( (Semaphore_pend(busyMutex, 0) == FALSE) || (EasyLink_CmdHandle_isValid(asyncCmdHndl)) )
+    //Check and take the busyMutex, then the Rx command
+    if (Semaphore_pend(busyMutex, 0) == FALSE)
+    {
+        return EasyLink_Status_Busy_Error;
+    }
+    if (EasyLink_CmdHandle_isValid(asyncCmdHndl))
     {
+        Semaphore_post(busyMutex);
         return EasyLink_Status_Busy_Error;
     }
 
     rxCb = cb;
 
-    pDataEntry = (rfc_dataEntryGeneral_t*) rxBuffer;
-    //data entry rx buffer includes hdr (len-1Byte), addr (max 8Bytes) and data
-    pDataEntry->length = 1 + EASYLINK_MAX_ADDR_SIZE + EASYLINK_MAX_DATA_LENGTH;
-    pDataEntry->status = 0;
-    dataQueue.pCurrEntry = (uint8_t*) pDataEntry;
-    dataQueue.pLastEntry = NULL;
-    EasyLink_cmdPropRxAdv.pQueue = &dataQueue;               /* Set the Data Entity queue for received data */
-    EasyLink_cmdPropRxAdv.pOutput = (uint8_t*)&rxStatistics;
+    resetRxQueue();
 
     if (absTime != 0)
     {
@@ -894,7 +1928,7 @@ EasyLink_Status EasyLink_receiveAsync(EasyLink_ReceiveCb cb, uint32_t absTime)
     if (asyncRxTimeOut != 0)
     {
         EasyLink_cmdPropRxAdv.endTrigger.triggerType = TRIG_ABSTIME;
-        EasyLink_cmdPropRxAdv.endTime = RF_getCurrentTime() + asyncRxTimeOut;
+        EasyLink_cmdPropRxAdv.endTime = (uint32_t)EasyLink_getAbsTime64() + asyncRxTimeOut;
     }
     else
     {
@@ -902,54 +1936,119 @@ EasyLink_Status EasyLink_receiveAsync(EasyLink_ReceiveCb cb, uint32_t absTime)
         EasyLink_cmdPropRxAdv.endTime = 0;
     }
 
-    //Clear the Rx statistics structure
-    memset(&rxStatistics, 0, sizeof(rfc_propRxOutput_t));
-
-    asyncCmdHndl = RF_postCmd(rfHandle, (RF_Op*)&EasyLink_cmdPropRxAdv,
-            RF_PriorityNormal, rxDoneCallback, EASYLINK_RF_EVENT_MASK);
+    applyIdleTimeout();
+    rxSubmitTime = cmdSubmitTime(absTime);
+    rxQueued = !asyncIdle();
+    rxTxTime = EASYLINK_RADIO_TIME_ALL_RX;
 
-    if (EasyLink_CmdHandle_isValid(asyncCmdHndl))
+    if (EasyLink_CmdHandle_isValid(postAsyncCmd((RF_Op*)&EasyLink_cmdPropRxAdv,
+            rxDoneCallback, &asyncCmdHndl)))
     {
         status = EasyLink_Status_Success;
     }
 
-    //busyMutex will be released in callback
+    //The Rx command is freed in callback
+    Semaphore_post(busyMutex);
 
     return status;
 }
 
 EasyLink_Status EasyLink_abort(void)
 {
-    EasyLink_Status status = EasyLink_Status_Cmd_Error;
+    EasyLink_Status status = EasyLink_Status_Success;
+    RF_CmdHandle cmdHndls[EASYLINK_NUM_TX_CMDS + 1];
+    RF_CmdHandle cmdHndl;
+    uint8_t numCmds = 0;
+    uint8_t newest;
+    uint8_t i;
 
     if ( (!configured) || suspended)
     {
         return EasyLink_Status_Config_Error;
     }
+
+    //Collect the queued commands, a chained Tx goes with its Rx
+    if (EasyLink_CmdHandle_isValid(asyncCmdHndl))
+    {
+        cmdHndls[numCmds++] = asyncCmdHndl;
+    }
+    for (i = 0; i < EASYLINK_NUM_TX_CMDS; i++)
+    {
+        if (txCmdPool[i].inUse && EasyLink_CmdHandle_isValid(txCmdPool[i].cmdHndl))
+        {
+            cmdHndls[numCmds++] = txCmdPool[i].cmdHndl;
+        }
+    }
+
     //check an Async command is running, if not return success
-    if (!EasyLink_CmdHandle_isValid(asyncCmdHndl))
+    if (numCmds == 0)
     {
         return EasyLink_Status_Aborted;
     }
 
-    //force abort (gracefull param set to 0)
-    if (RF_cancelCmd(rfHandle, asyncCmdHndl, 0) == RF_StatSuccess)
+    //The RF driver hands out increasing handles, cancel the newest first so
+    //that no queued command starts while the older ones are cancelled
+    while (numCmds > 0)
     {
-       /* Wait for Command to complete */
-       RF_EventMask result = RF_pendCmd(rfHandle, asyncCmdHndl, (RF_EventLastCmdDone | RF_EventCmdError |
-               RF_EventCmdAborted | RF_EventCmdCancelled | RF_EventCmdStopped));
+        newest = 0;
+        for (i = 1; i < numCmds; i++)
+        {
+            if (cmdHndls[i] > cmdHndls[newest])
+            {
+                newest = i;
+            }
+        }
+        cmdHndl = cmdHndls[newest];
+        cmdHndls[newest] = cmdHndls[--numCmds];
 
-       if (result & RF_EventLastCmdDone)
-       {
-           status = EasyLink_Status_Success;
-       }
+        //force abort (gracefull param set to 0)
+        if (RF_cancelCmd(rfHandle, cmdHndl, 0) == RF_StatSuccess)
+        {
+           /* Wait for Command to complete */
+           RF_EventMask result = RF_pendCmd(rfHandle, cmdHndl, (RF_EventLastCmdDone | RF_EventCmdError |
+                   RF_EventCmdAborted | RF_EventCmdCancelled | RF_EventCmdStopped));
+
+           if (!(result & RF_EventLastCmdDone))
+           {
+               status = EasyLink_Status_Cmd_Error;
+           }
+        }
+        else
+        {
+           status = EasyLink_Status_Cmd_Error;
+        }
+    }
+
+    return status;
+}
+
+//Loads the addresses that do not fit in the RF core filter, returns false
+//if a table of addresses longer than a byte is not sorted
+static bool setSwAddrFilter(const uint8_t *table, uint8_t numAddrs)
+{
+    uint8_t i;
+
+    if (addrSize == 1)
+    {
+        memset(swAddrBitmap, 0, sizeof(swAddrBitmap));
+        for (i = 0; i < numAddrs; i++)
+        {
+            swAddrBitmap[table[i] >> 3] |= (1 << (table[i] & 0x07));
+        }
     }
     else
     {
-       status = EasyLink_Status_Cmd_Error;
+        for (i = 1; i < numAddrs; i++)
+        {
+            if (memcmp(&table[(i - 1) * addrSize], &table[i * addrSize], addrSize) >= 0)
+            {
+                return false;
+            }
+        }
+        swAddrTable = table;
+        swAddrNum = numAddrs;
     }
-
-    return status;
+    return true;
 }
 
 EasyLink_Status EasyLink_enableRxAddrFilter(uint8_t* pui8AddrFilterTable, uint8_t ui8AddrSize, uint8_t ui8NumAddrs)
@@ -960,7 +2059,7 @@ EasyLink_Status EasyLink_enableRxAddrFilter(uint8_t* pui8AddrFilterTable, uint8_
     {
         return EasyLink_Status_Config_Error;
     }
-    if ( Semaphore_pend(busyMutex, 0) == FALSE )
+    if (!takeBusyMutex())
     {
         return EasyLink_Status_Busy_Error;
     }
@@ -968,18 +2067,32 @@ EasyLink_Status EasyLink_enableRxAddrFilter(uint8_t* pui8AddrFilterTable, uint8_
     if ( (pui8AddrFilterTable != NULL) &&
             (ui8AddrSize != 0) && (ui8NumAddrs != 0) &&
             (ui8AddrSize == addrSize) &&
-            (ui8NumAddrs <= EASYLINK_MAX_ADDR_FILTERS) )
+            ( (ui8NumAddrs <= EASYLINK_MAX_ADDR_FILTERS) ||
+              setSwAddrFilter(pui8AddrFilterTable, ui8NumAddrs) ) )
     {
-        memcpy(addrFilterTable, pui8AddrFilterTable, EASYLINK_MAX_ADDR_SIZE * EASYLINK_MAX_ADDR_FILTERS);
+        //The RF core filters on up to EASYLINK_MAX_ADDR_FILTERS entries
+        if (ui8NumAddrs <= EASYLINK_MAX_ADDR_FILTERS)
+        {
+            swAddrFilterEnabled = false;
+            EasyLink_cmdPropRxAdv.addrConf.numAddr = ui8NumAddrs;
+            EasyLink_cmdPropRxAdv.pktConf.filterOp = 0;
+        }
+        else
+        {
+            //Packets it does not match are kept and checked by swAddrFilterRejects
+            swAddrFilterEnabled = true;
+            EasyLink_cmdPropRxAdv.addrConf.numAddr = EASYLINK_MAX_ADDR_FILTERS;
+            EasyLink_cmdPropRxAdv.pktConf.filterOp = 1;
+        }
+        memcpy(addrFilterTable, pui8AddrFilterTable, ui8AddrSize * EasyLink_cmdPropRxAdv.addrConf.numAddr);
         EasyLink_cmdPropRxAdv.addrConf.addrSize = ui8AddrSize;
-        EasyLink_cmdPropRxAdv.addrConf.numAddr = ui8NumAddrs;
-        EasyLink_cmdPropRxAdv.pktConf.filterOp = 0;
 
         status = EasyLink_Status_Success;
     }
     else if (pui8AddrFilterTable == NULL)
     {
         //disable filter
+        swAddrFilterEnabled = false;
         EasyLink_cmdPropRxAdv.pktConf.filterOp = 1;
 
         status = EasyLink_Status_Success;
@@ -997,7 +2110,13 @@ EasyLink_Status EasyLink_setCtrl(EasyLink_CtrlOption Ctrl, uint32_t ui32Value)
     switch(Ctrl)
     {
         case EasyLink_Ctrl_AddSize:
-            if (ui32Value <= EASYLINK_MAX_ADDR_SIZE)
+            //The filter tables were set up for the old size
+            if ( (ui32Value != addrSize) &&
+                 ((EasyLink_cmdPropRxAdv.pktConf.filterOp == 0) || swAddrFilterEnabled) )
+            {
+                status = EasyLink_Status_Config_Error;
+            }
+            else if (ui32Value <= EASYLINK_MAX_ADDR_SIZE)
             {
                 addrSize = (uint8_t) ui32Value;
                 EasyLink_cmdPropRxAdv.addrConf.addrSize = addrSize;
@@ -1023,6 +2142,10 @@ EasyLink_Status EasyLink_setCtrl(EasyLink_CtrlOption Ctrl, uint32_t ui32Value)
         case EasyLink_Ctrl_Test_Signal:
             status = enableTestMode(EasyLink_Ctrl_Test_Signal);
             break;
+        case EasyLink_Ctrl_Next_Idle_TimeOut:
+            nextIdleTimeout = ui32Value;
+            status = EasyLink_Status_Success;
+            break;
     }
 
     return status;
@@ -1055,6 +2178,10 @@ EasyLink_Status EasyLink_getCtrl(EasyLink_CtrlOption Ctrl, uint32_t* pui32Value)
             *pui32Value = 0;
             status = EasyLink_Status_Success;
             break;
+        case EasyLink_Ctrl_Next_Idle_TimeOut:
+            *pui32Value = nextIdleTimeout;
+            status = EasyLink_Status_Success;
+            break;
     }
 
     return status;
@@ -1098,3 +2225,44 @@ EasyLink_Status EasyLink_getIeeeAddr(uint8_t *ieeeAddr)
 
     return status;
 }
+
+void EasyLink_getStats(EasyLink_Stats *stats)
+{
+    uint64_t idleUs;
+    UInt key = Hwi_disable();
+
+    *stats = radioStats;
+
+    //The radio is still powered if the last command ended within the timeout
+    if (lastCmdEndValid && asyncIdle())
+    {
+        idleUs = EasyLink_RadioTime_To_us(EasyLink_getAbsTime64() - lastCmdEndTime);
+        stats->idleTimeUs += (idleUs < lastCmdIdleTimeout) ? idleUs : lastCmdIdleTimeout;
+    }
+
+    Hwi_restore(key);
+}
+
+void EasyLink_resetStats(void)
+{
+    UInt key = Hwi_disable();
+    memset(&radioStats, 0, sizeof(radioStats));
+    Hwi_restore(key);
+}
+
+EasyLink_Status EasyLink_setRxEventCb(EasyLink_RxEventCb cb, uint32_t ui32EventMask)
+{
+    UInt key;
+
+    if (ui32EventMask & ~((uint32_t)(EasyLink_RxEvent_CrcError | EasyLink_RxEvent_SyncOnly)))
+    {
+        return EasyLink_Status_Param_Error;
+    }
+
+    key = Hwi_disable();
+    rxEventCb = cb;
+    rxEventMask = ui32EventMask;
+    Hwi_restore(key);
+
+    return EasyLink_Status_Success;
+}
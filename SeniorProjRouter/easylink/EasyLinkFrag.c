@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2015-2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/***** Includes *****/
+#include "EasyLinkFrag.h"
+
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/knl/Clock.h>
+
+
+/***** Defines *****/
+#define EasyLinkFrag_ms_To_Ticks(ms) ((uint32_t)(((uint64_t)(ms) * 1000) / Clock_tickPeriod))
+
+#define EASYLINKFRAG_INDEX_MASK             0x7F
+#define EASYLINKFRAG_STATUS_REQUEST         0x80
+
+
+/***** Type declarations *****/
+enum ReassemblyState {
+    ReassemblyState_Free,
+    ReassemblyState_Assembling,
+    ReassemblyState_Complete,       /* Handed to the caller until released */
+    ReassemblyState_Done,           /* Released, kept to recognize late retransmissions */
+};
+
+struct Reassembly {
+    enum ReassemblyState state;
+    uint8_t source;
+    uint8_t messageId;
+    uint8_t count;
+    uint8_t fragmentSize;
+    uint16_t length;                /* Known once the last fragment is in */
+    uint32_t received;
+    uint32_t lastTicks;
+    uint8_t data[EASYLINKFRAG_MAX_MESSAGE_LENGTH];
+};
+
+
+/***** Variable declarations *****/
+static struct Reassembly reassemblies[EASYLINKFRAG_NUM_REASSEMBLY_BUFFERS];
+
+struct EasyLinkFrag_Stats easyLinkFragStats;    /* not static so you can see in ROV */
+
+
+/***** Prototypes *****/
+static uint32_t allFragments(uint8_t count);
+static void expireReassemblies(uint32_t now);
+static struct Reassembly* findReassembly(uint8_t source, uint8_t messageId);
+static struct Reassembly* allocateReassembly(void);
+
+
+/***** Function definitions *****/
+bool EasyLinkFrag_startMessage(struct EasyLinkFrag_Sender* sender, const uint8_t* data,
+                               uint16_t length, uint8_t messageId, uint8_t maxFrameLength)
+{
+    uint16_t count;
+
+    if ((length == 0) || (length > EASYLINKFRAG_MAX_MESSAGE_LENGTH) ||
+        (maxFrameLength <= EASYLINKFRAG_HEADER_LENGTH))
+    {
+        return false;
+    }
+
+    sender->fragmentSize = maxFrameLength - EASYLINKFRAG_HEADER_LENGTH;
+    count = (length + sender->fragmentSize - 1) / sender->fragmentSize;
+    if (count > EASYLINKFRAG_MAX_FRAGMENTS)
+    {
+        return false;
+    }
+
+    sender->data = data;
+    sender->length = length;
+    sender->messageId = messageId;
+    sender->count = count;
+    sender->lastSent = 0;
+    sender->pending = allFragments(count);
+    sender->delivered = 0;
+
+    return true;
+}
+
+uint8_t EasyLinkFrag_nextFragment(struct EasyLinkFrag_Sender* sender, uint8_t* frame)
+{
+    uint8_t index = 0;
+    uint16_t offset;
+    uint8_t dataLength;
+
+    if (sender->pending == 0)
+    {
+        return 0;
+    }
+
+    while (!(sender->pending & (1UL << index)))
+    {
+        index++;
+    }
+    sender->pending &= ~(1UL << index);
+    sender->lastSent = index;
+
+    offset = (uint16_t)index * sender->fragmentSize;
+    dataLength = (index == sender->count - 1) ? (sender->length - offset) : sender->fragmentSize;
+
+    frame[0] = EASYLINKFRAG_TYPE_DATA;
+    frame[1] = sender->messageId;
+    frame[2] = index;
+    frame[3] = sender->count;
+    frame[4] = sender->fragmentSize;
+
+    /* The end of the burst asks the receiver what is still missing */
+    if (sender->pending == 0)
+    {
+        frame[2] |= EASYLINKFRAG_STATUS_REQUEST;
+    }
+
+    memcpy(&frame[EASYLINKFRAG_HEADER_LENGTH], &sender->data[offset], dataLength);
+
+    return EASYLINKFRAG_HEADER_LENGTH + dataLength;
+}
+
+bool EasyLinkFrag_handleStatus(struct EasyLinkFrag_Sender* sender, const uint8_t* frame,
+                               uint8_t length)
+{
+    uint32_t received;
+
+    if ((length >= EASYLINKFRAG_STATUS_LENGTH) && (frame[0] == EASYLINKFRAG_TYPE_STATUS) &&
+        (frame[1] == sender->messageId))
+    {
+        received = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) |
+                   ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+
+        sender->delivered |= received & allFragments(sender->count);
+        sender->pending = allFragments(sender->count) & ~sender->delivered;
+    }
+
+    return EasyLinkFrag_isDelivered(sender);
+}
+
+void EasyLinkFrag_statusTimeout(struct EasyLinkFrag_Sender* sender)
+{
+    if (!EasyLinkFrag_isDelivered(sender))
+    {
+        sender->pending |= 1UL << sender->lastSent;
+    }
+}
+
+bool EasyLinkFrag_isDelivered(const struct EasyLinkFrag_Sender* sender)
+{
+    return sender->delivered == allFragments(sender->count);
+}
+
+EasyLinkFrag_Status EasyLinkFrag_receive(uint8_t source, const uint8_t* frame, uint8_t length,
+                                         struct EasyLinkFrag_Message* message)
+{
+    struct Reassembly* reassembly;
+    uint32_t now = Clock_getTicks();
+    uint8_t index;
+    uint8_t count;
+    uint8_t fragmentSize;
+    uint8_t dataLength;
+    uint16_t offset;
+
+    if ((length < EASYLINKFRAG_HEADER_LENGTH) || (frame[0] != EASYLINKFRAG_TYPE_DATA))
+    {
+        return EasyLinkFrag_Status_NotFragment;
+    }
+
+    index = frame[2] & EASYLINKFRAG_INDEX_MASK;
+    count = frame[3];
+    fragmentSize = frame[4];
+    dataLength = length - EASYLINKFRAG_HEADER_LENGTH;
+    offset = (uint16_t)index * fragmentSize;
+
+    message->source = source;
+    message->messageId = frame[1];
+    message->statusRequested = (frame[2] & EASYLINKFRAG_STATUS_REQUEST) ? 1 : 0;
+    message->received = 0;
+    message->data = NULL;
+    message->length = 0;
+
+    /* Every fragment but the last is full, and the message must fit a buffer */
+    if ((count == 0) || (count > EASYLINKFRAG_MAX_FRAGMENTS) || (index >= count) ||
+        (dataLength == 0) || (dataLength > fragmentSize) ||
+        ((index != count - 1) && (dataLength != fragmentSize)) ||
+        ((uint32_t)offset + dataLength > EASYLINKFRAG_MAX_MESSAGE_LENGTH))
+    {
+        easyLinkFragStats.fragmentsInvalid++;
+        return EasyLinkFrag_Status_Invalid;
+    }
+
+    expireReassemblies(now);
+
+    reassembly = findReassembly(source, message->messageId);
+    if (reassembly == NULL)
+    {
+        reassembly = allocateReassembly();
+        if (reassembly == NULL)
+        {
+            easyLinkFragStats.fragmentsNoBuffer++;
+            return EasyLinkFrag_Status_NoBuffer;
+        }
+
+        reassembly->state = ReassemblyState_Assembling;
+        reassembly->source = source;
+        reassembly->messageId = message->messageId;
+        reassembly->count = count;
+        reassembly->fragmentSize = fragmentSize;
+        reassembly->length = 0;
+        reassembly->received = 0;
+    }
+    else if ((reassembly->count != count) || (reassembly->fragmentSize != fragmentSize))
+    {
+        easyLinkFragStats.fragmentsInvalid++;
+        return EasyLinkFrag_Status_Invalid;
+    }
+
+    reassembly->lastTicks = now;
+
+    if (reassembly->received & (1UL << index))
+    {
+        easyLinkFragStats.fragmentsDuplicate++;
+        message->received = reassembly->received;
+        return EasyLinkFrag_Status_Duplicate;
+    }
+
+    memcpy(&reassembly->data[offset], &frame[EASYLINKFRAG_HEADER_LENGTH], dataLength);
+    reassembly->received |= 1UL << index;
+    if (index == count - 1)
+    {
+        reassembly->length = offset + dataLength;
+    }
+    message->received = reassembly->received;
+
+    if (reassembly->received != allFragments(count))
+    {
+        return EasyLinkFrag_Status_Incomplete;
+    }
+
+    reassembly->state = ReassemblyState_Complete;
+    easyLinkFragStats.messagesComplete++;
+    message->data = reassembly->data;
+    message->length = reassembly->length;
+
+    return EasyLinkFrag_Status_Complete;
+}
+
+void EasyLinkFrag_release(const struct EasyLinkFrag_Message* message)
+{
+    struct Reassembly* reassembly = findReassembly(message->source, message->messageId);
+
+    if ((reassembly != NULL) && (reassembly->state == ReassemblyState_Complete))
+    {
+        reassembly->state = ReassemblyState_Done;
+    }
+}
+
+uint8_t EasyLinkFrag_buildStatus(const struct EasyLinkFrag_Message* message, uint8_t* frame)
+{
+    frame[0] = EASYLINKFRAG_TYPE_STATUS;
+    frame[1] = message->messageId;
+    frame[2] = (uint8_t)(message->received);
+    frame[3] = (uint8_t)(message->received >> 8);
+    frame[4] = (uint8_t)(message->received >> 16);
+    frame[5] = (uint8_t)(message->received >> 24);
+
+    return EASYLINKFRAG_STATUS_LENGTH;
+}
+
+void EasyLinkFrag_getStats(struct EasyLinkFrag_Stats* stats)
+{
+    *stats = easyLinkFragStats;
+}
+
+static uint32_t allFragments(uint8_t count)
+{
+    return (count >= 32) ? 0xFFFFFFFF : ((1UL << count) - 1);
+}
+
+static void expireReassemblies(uint32_t now)
+{
+    uint8_t i;
+
+    for (i = 0; i < EASYLINKFRAG_NUM_REASSEMBLY_BUFFERS; i++)
+    {
+        if ((now - reassemblies[i].lastTicks) <=
+            EasyLinkFrag_ms_To_Ticks(EASYLINKFRAG_REASSEMBLY_TIMEOUT_MS))
+        {
+            continue;
+        }
+
+        if (reassemblies[i].state == ReassemblyState_Assembling)
+        {
+            reassemblies[i].state = ReassemblyState_Free;
+            easyLinkFragStats.messagesTimedOut++;
+        }
+        else if (reassemblies[i].state == ReassemblyState_Done)
+        {
+            /* Late retransmissions are over, let the message id be reused */
+            reassemblies[i].state = ReassemblyState_Free;
+        }
+    }
+}
+
+static struct Reassembly* findReassembly(uint8_t source, uint8_t messageId)
+{
+    uint8_t i;
+
+    for (i = 0; i < EASYLINKFRAG_NUM_REASSEMBLY_BUFFERS; i++)
+    {
+        if ((reassemblies[i].state != ReassemblyState_Free) &&
+            (reassemblies[i].source == source) && (reassemblies[i].messageId == messageId))
+        {
+            return &reassemblies[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Takes a free buffer, or else the one released the longest ago */
+static struct Reassembly* allocateReassembly(void)
+{
+    struct Reassembly* oldest = NULL;
+    uint8_t i;
+
+    for (i = 0; i < EASYLINKFRAG_NUM_REASSEMBLY_BUFFERS; i++)
+    {
+        if (reassemblies[i].state == ReassemblyState_Free)
+        {
+            return &reassemblies[i];
+        }
+
+        if ((reassemblies[i].state == ReassemblyState_Done) &&
+            ((oldest == NULL) ||
+             ((int32_t)(reassemblies[i].lastTicks - oldest->lastTicks) < 0)))
+        {
+            oldest = &reassemblies[i];
+        }
+    }
+
+    return oldest;
+}